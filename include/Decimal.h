@@ -24,8 +24,13 @@
 #define DECIMAL_VLN_BCD_DECIMAL_H
 
 #include "DecimalStatus.h"
+#include "DecimalRoundingMode.h"
+#include "DecimalSharedDigits.h"
 
 #include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
 #include <limits>
 #include <cstdint>
 #include <optional>
@@ -35,29 +40,85 @@
 namespace sav
 {
 	class DecimalIntegerDivisionResult;
+	class DecimalExtendedGcdResult;
+	class DecimalAccumulator;
+	class DecimalConcurrentAccumulator;
+	class DecimalMontgomeryContext;
+	class DecimalView;
 
 	class Decimal
 	{
+		friend class DecimalAccumulator;
+		friend class DecimalConcurrentAccumulator;
+		friend class DecimalMontgomeryContext;
+		friend class DecimalView;
+
+		friend std::from_chars_result from_chars(const char* _first, const char* _last, Decimal& _value);
+
+		friend Decimal DotProduct(const std::vector<Decimal>& _lhs, const std::vector<Decimal>& _rhs);
+		friend Decimal DotProduct(const std::vector<Decimal>& _lhs, const std::vector<std::uint64_t>& _rhs);
+
+		friend void RadixSort(std::vector<Decimal>& _values);
+
 		public:
-			// Constructor for an initial unsigned value.
-			explicit Decimal(unsigned int _initial);
+			// Constructor for an initial unsigned value (the digits are written directly from the native value).
+			explicit Decimal(std::uint64_t _initial);
 
-			// Constructor from string in base10, e.g. "1234".
-			explicit Decimal(const std::string& _fromString);
+			// Constructor from string in base10, e.g. "1234" (Error_InvalidArgument status if it is not a number).
+			explicit Decimal(std::string_view _fromString);
 
 			// Constructor for an empty value.
 			explicit Decimal();
 
-			DecimalStatus SetFromString(const std::string& _fromString);
+			/**
+			 * SetFromString - set from a base10 string, e.g. "1234" (an empty string is zero).
+			 * @see from_chars in DecimalCharConv.h to parse from a buffer without this strictness
+			 * @param _fromString
+			 * @return Ok or Error_InvalidArgument if a character is not a digit (the value is then zero)
+			 */
+			DecimalStatus SetFromString(std::string_view _fromString);
+
+#ifdef __SIZEOF_INT128__
+			/**
+			 * FromUInt128 - value of a native 128-bit unsigned integer.
+			 * A factory rather than a constructor, so that integer literals keep choosing Decimal(std::uint64_t).
+			 */
+			static Decimal FromUInt128(unsigned __int128 _value);
+#endif
 
+			/**
+			 * ToUInt, ToUInt64, ToUInt128 - value as a native unsigned integer, O(1):
+			 * a normalized value fits exactly when its digit count does, so only that many digits are read.
+			 * @return value or std::nullopt if it does not fit the type
+			 */
 			std::optional<unsigned int> ToUInt() const;
+			std::optional<std::uint64_t> ToUInt64() const;
+
+			// Value clamped to std::numeric_limits<std::uint64_t>::max().
+			std::uint64_t ToUInt64Saturated() const;
+
+#ifdef __SIZEOF_INT128__
+			std::optional<unsigned __int128> ToUInt128() const;
+
+			// Value clamped to the largest unsigned __int128.
+			unsigned __int128 ToUInt128Saturated() const;
+#endif
 
 			/**
 			 * ToString - convert stored decimal value to a base10 string, e.g. "1234".
+			 * @see to_chars in DecimalCharConv.h to write into a caller buffer instead
 		 	 * @return value as base10
 		 	 */
 			std::string ToString() const;
 
+			/**
+			 * ToCachedString - ToString for values formatted more than once.
+			 * The string is cached with the digits (and shared by copies), so that formatting an unchanged value again
+			 * is a copy; any modification of the value drops it. The cache costs a copy of the text, ToString skips it.
+		 	 * @return value as base10
+		 	 */
+			std::string ToCachedString() const;
+
 			// Returns false if Decimal integrity has been violated (e.g. divided by zero), true otherwise
 			explicit operator bool() const noexcept;
 
@@ -78,13 +139,85 @@ namespace sav
 			// in the result pair, first is quotient (integer part) and second is remainder
 			DecimalIntegerDivisionResult operator/(const Decimal& _rhs) const;
 
+			/**
+			 * DivideAndRound - divide and round the quotient to an integer.
+			 * The rounding is decided from the remainder (2 * remainder against the divisor), without a second division.
+			 * @param _divisor
+			 * @param _mode
+			 * @return rounded quotient, Error_DividedByZero status for a zero divisor
+			 */
+			Decimal DivideAndRound(const Decimal& _divisor, DecimalRoundingMode _mode) const;
+
 			/**
 			 * DivideAndRoundInBase10 - divide and round in base10 using 4/5 rule.
+			 * Same as DivideAndRound with DecimalRoundingMode::HalfUp.
 			 * @param _divisor
 			 * @return rounded result
 			 */
 			Decimal DivideAndRoundInBase10(const Decimal& _divisor) const;
 
+			/**
+			 * DivExact - divide by a divisor which is known to divide this value without remainder.
+			 * Cheaper than operator/ : the quotient is built from the least significant end without any remainder.
+			 * If the remainder is not zero the result is meaningless; debug builds check it
+			 * and return a Decimal with Error_InvalidArgument status instead.
+			 * @param _divisor
+			 * @return exact quotient
+			 */
+			Decimal DivExact(const Decimal& _divisor) const;
+
+			/**
+			 * Gcd - greatest common divisor (Lehmer's algorithm, binary GCD for single-limb operands).
+			 * Gcd(0, 0) == 0.
+			 */
+			static Decimal Gcd(const Decimal& _lhs, const Decimal& _rhs);
+
+			/**
+			 * Lcm - least common multiple, Lcm(x, 0) == 0.
+			 */
+			static Decimal Lcm(const Decimal& _lhs, const Decimal& _rhs);
+
+			/**
+			 * ExtendedGcd - greatest common divisor with Bezout coefficients.
+			 * @see DecimalExtendedGcdResult for the sign convention
+			 */
+			static DecimalExtendedGcdResult ExtendedGcd(const Decimal& _lhs, const Decimal& _rhs);
+
+			/**
+			 * Square - this value squared, cheaper than (*this) * (*this).
+			 * Every off-diagonal limb product is computed once (Karatsuba squaring for large values).
+			 */
+			Decimal Square() const;
+
+			/**
+			 * Pow - integer power by left-to-right binary exponentiation.
+			 * @param _exponent
+			 * @return this value raised to _exponent (Pow(0) == 1)
+			 */
+			Decimal Pow(std::uint64_t _exponent) const;
+
+			// 10^_exponent and 2^_exponent
+			static Decimal Pow10(std::uint64_t _exponent);
+			static Decimal Pow2(std::uint64_t _exponent);
+
+			/**
+			 * Serialize - append the compact binary encoding of this value to the buffer:
+			 * LEB128 count of base256 digits followed by the digits, little-endian (zero is encoded as a single 0x00).
+			 * @param _buffer
+			 */
+			void Serialize(std::vector<std::uint8_t>& _buffer) const;
+
+			// Size of the Serialize encoding in bytes.
+			std::size_t SerializedSize() const;
+
+			/**
+			 * Deserialize - read a value written by Serialize, @see DecimalView::Parse to read it without copying.
+			 * @param _data
+			 * @param _size bytes available (trailing bytes are ignored)
+			 * @return Ok or Error_InvalidArgument if the data is truncated or malformed (this value is left unchanged)
+			 */
+			DecimalStatus Deserialize(const std::uint8_t* _data, std::size_t _size);
+
 			// Mutable arithmetic operators (implementation depends on the immutable ones).
 			Decimal& operator+=(const Decimal& _rhs);
 			Decimal& operator-=(const Decimal& _rhs);
@@ -101,6 +234,12 @@ namespace sav
 		 	 */
 			bool EqualsZero() const noexcept;
 
+			/**
+			 * Hash - hash of the normalized digits (8 at a time, wyhash-style multiply-and-fold mixing),
+			 * equal values hash equally. Also available as std::hash<sav::Decimal>.
+			 */
+			std::size_t Hash() const;
+
 		protected:
 			enum
 			{
@@ -108,32 +247,59 @@ namespace sav
 				kBase256 = std::numeric_limits<std::uint8_t>::max() + 1
 			};
 
-			std::vector<std::uint8_t> m_digits;
-
-			DecimalStatus m_status = DecimalStatus::Ok;
-
-			static const Decimal kDecimalWhichEqualUnsignedIntMax;
-
-			static const Decimal kDecimalWhichEqualBase10;
+			// Little-endian base256 digits, shared between copies until one of them is modified.
+			DecimalSharedDigits m_digits;
 
 			/**
-			 * UnsafeIntegerPower - perform integer exponentiation without overflow checks.
-			 * For internal use in ToUInt() function.
-			 * @param _base
-			 * @param _index
-			 * @return strictly integer result
+			 * Count of implicit least significant zero 64-bit limbs: the value is m_digits * 2^(64 * m_zeroLimbs),
+			 * so that scaled values do not carry (and walk through) their low zeros.
+			 * Whole zero limbs at the low end of m_digits are always moved here (zero has none),
+			 * equal values thus have equal representations.
 			 */
-			static unsigned int UnsafeIntegerPower(unsigned int _base, unsigned int _index);
+			std::size_t m_zeroLimbs = 0;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
 
 			/**
-			 * Normalize - remove unsignificant zeros.
+			 * Normalize - remove unsignificant zeros and move whole zero low limbs into m_zeroLimbs.
 			 * (e.g. for base10 : 0001023 -> 1023)
 			 */
 			void Normalize();
 
+			// Value as 64-bit limbs (implicit zero limbs included), most significant zero limbs trimmed.
+			std::vector<std::uint64_t> ToLimbs() const;
+
+			/**
+			 * AssignLimbs - set the value to _limbs * 2^(64 * _zeroLimbs) (e.g. a kernel result), normalized.
+			 * @param _limbs little-endian 64-bit limbs
+			 * @param _zeroLimbs implicit zero limbs below _limbs
+			 */
+			void AssignLimbs(const std::vector<std::uint64_t>& _limbs, std::size_t _zeroLimbs = 0);
+
+			// Make the implicit zero limbs explicit digits again, for the byte-wise in-place operators.
+			void Expand();
+
+			// Count of base256 digits, implicit zero limbs included, @see DecimalInline.h
+			std::size_t DigitCount() const;
+
+			// Returns true if the value fits one 64-bit limb (no implicit zero limbs), @see DecimalInline.h
+			bool SingleLimb() const;
+
+			// Value of a SingleLimb() decimal.
+			std::uint64_t SingleLimbValue() const;
+
+			// Three-way comparison: negative, zero or positive.
+			int Compare(const Decimal& _rhs) const;
+
+			// General paths of the operators on 64-bit limbs, for values beyond the single-limb fast paths.
+			int CompareLimbs(const Decimal& _rhs) const;
+			Decimal AddLimbs(const Decimal& _rhs) const;
+			Decimal SubtractLimbs(const Decimal& _rhs) const;
+			Decimal MultiplyLimbs(const Decimal& _rhs) const;
+
 			/**
 		 	 * AmplifyInBase256 - Amplify decimal value by
-		 	 * @param _digits in base256
+		 	 * @param _digits in base256 (whole limbs of 8 digits only change m_zeroLimbs)
 		 	 * @example 0xFF-> Amplify(1) -> 0x00'FF (little-endian)
 		 	 */
 			Decimal& AmplifyInBase256(int _digits);
@@ -148,4 +314,20 @@ namespace sav
 	};
 }
 
+namespace std
+{
+	template<>
+	struct hash<sav::Decimal>
+	{
+		std::size_t operator()(const sav::Decimal& _value) const
+		{
+			return _value.Hash();
+		}
+	};
+}
+
+#ifdef DECIMAL_VLN_BCD_INLINE
+#include "DecimalInline.h"
+#endif
+
 #endif //DECIMAL_VLN_BCD_DECIMAL_H
@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALACCUMULATOR_H
+#define DECIMAL_VLN_BCD_DECIMALACCUMULATOR_H
+
+#include "Decimal.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace sav
+{
+	class DecimalConcurrentAccumulator;
+
+	/**
+	 * @class DecimalAccumulator
+	 * Running sum with deferred carry propagation (carry-save).
+	 * Every base256 digit of an addend goes to its own 64-bit column, so an addition
+	 * neither reallocates nor ripples a carry through the whole number.
+	 * Carries are propagated only when a column could overflow or when the value is read.
+	 */
+	class DecimalAccumulator
+	{
+		friend class DecimalConcurrentAccumulator;
+
+		public:
+			// Constructor for an empty (zero) sum.
+			explicit DecimalAccumulator();
+
+			// Constructor for a sum starting from an initial value.
+			explicit DecimalAccumulator(const Decimal& _initial);
+
+			DecimalAccumulator& Add(const Decimal& _addend);
+			DecimalAccumulator& Add(std::uint64_t _addend);
+
+			// Batch additions (columns are grown once for the widest addend).
+			DecimalAccumulator& Add(const std::vector<Decimal>& _addends);
+			DecimalAccumulator& Add(const std::vector<std::uint64_t>& _addends);
+
+			// Merge another running sum into this one.
+			DecimalAccumulator& Add(const DecimalAccumulator& _other);
+
+			/**
+			 * AddProduct - add a product of two multipliers without materializing it.
+			 * Every partial product of two digits goes straight to its column.
+			 * @param _lhs
+			 * @param _rhs
+			 */
+			DecimalAccumulator& AddProduct(const Decimal& _lhs, const Decimal& _rhs);
+			DecimalAccumulator& AddProduct(const Decimal& _lhs, std::uint64_t _rhs);
+
+			DecimalAccumulator& operator+=(const Decimal& _addend);
+			DecimalAccumulator& operator+=(std::uint64_t _addend);
+
+			/**
+			 * Value - propagate pending carries and return the sum.
+			 * @return normalized sum, or a Decimal with error status if any addend had one
+			 */
+			Decimal Value() const;
+
+			// Reset the sum to zero (allocated columns are kept for reuse).
+			void Reset();
+
+			// Returns false if any of the addends had its integrity violated, true otherwise
+			explicit operator bool() const noexcept;
+
+		protected:
+			enum
+			{
+				kBase256 = std::numeric_limits<std::uint8_t>::max() + 1,
+				kDigitBits = std::numeric_limits<std::uint8_t>::digits
+			};
+
+			// Columns are allowed to grow up to this bound before carries have to be propagated,
+			// which leaves room for the carry coming from the previous column.
+			static constexpr std::uint64_t kColumnLimit = std::uint64_t{1} << 62;
+
+			// Column i holds a not yet normalized sum of all base256 digits with weight 256^i.
+			std::vector<std::uint64_t> m_columns;
+
+			// Upper bound of any column value since the last carry propagation.
+			std::uint64_t m_columnBound = 0;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
+
+			/**
+			 * ReserveHeadroom - make sure every column can take another
+			 * @param _perColumn without overflowing, propagating carries if needed.
+			 */
+			void ReserveHeadroom(std::uint64_t _perColumn);
+
+			/**
+			 * PropagateCarries - bring every column back to a single base256 digit.
+			 */
+			void PropagateCarries();
+
+			// Add base256 digits into the columns from _firstColumn on, without any carry propagation.
+			void AddDigits(const std::uint8_t* _digits, std::size_t _count, std::size_t _firstColumn);
+
+			// Add a product of base256 digit sequences into the columns from _firstColumn on, without any carry propagation.
+			void AddDigitsProduct(const std::uint8_t* _lhs, std::size_t _lhsCount,
+				const std::uint8_t* _rhs, std::size_t _rhsCount, std::size_t _firstColumn);
+
+			/**
+			 * AddColumns - add not yet normalized columns (e.g. of another accumulator).
+			 * @param _columns columns in the same layout as m_columns
+			 * @param _bound upper bound of any of the added column values
+			 */
+			void AddColumns(const std::vector<std::uint64_t>& _columns, std::uint64_t _bound);
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALACCUMULATOR_H
@@ -0,0 +1,328 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALBOUNDEDQUEUE_H
+#define DECIMAL_VLN_BCD_DECIMALBOUNDEDQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace sav
+{
+	/**
+	 * @class DecimalSpscQueue
+	 * Bounded lock-free queue for exactly one producer thread and one consumer thread.
+	 *
+	 * A ring of Capacity() slots (the requested capacity rounded up to a power of two). The producer owns the tail
+	 * index and the consumer the head index: each publishes its own index with release semantics after touching
+	 * a slot and reads the other one with acquire semantics, so a slot is completely written before it is read
+	 * and completely read before it is overwritten. Each side also keeps the last index it saw of the other side
+	 * and reloads it only when the ring looks full (empty), so the shared cache lines are rarely touched.
+	 */
+	template<typename T>
+	class DecimalSpscQueue
+	{
+		public:
+			explicit DecimalSpscQueue(std::size_t _capacity);
+
+			DecimalSpscQueue(const DecimalSpscQueue&) = delete;
+			DecimalSpscQueue& operator=(const DecimalSpscQueue&) = delete;
+
+			/**
+			 * TryPush - producer side, never waits.
+			 * @return false if the queue is full (_value is then not moved from)
+			 */
+			bool TryPush(T&& _value);
+
+			/**
+			 * TryPop - consumer side, never waits.
+			 * @return false if the queue is empty
+			 */
+			bool TryPop(T& _value);
+
+			// Blocking variants: yield while the queue is full (the backpressure on a faster producer) or empty.
+			void Push(T&& _value);
+			void Pop(T& _value);
+
+			std::size_t Capacity() const noexcept;
+
+		protected:
+			enum
+			{
+				kCacheLineSize = 64
+			};
+
+			std::unique_ptr<T[]> m_slots;
+
+			std::size_t m_mask;
+
+			// Consumer side: next slot to read, and the last tail seen.
+			alignas(kCacheLineSize) std::atomic<std::size_t> m_head{0};
+			std::size_t m_tailSeen = 0;
+
+			// Producer side: next slot to write, and the last head seen.
+			alignas(kCacheLineSize) std::atomic<std::size_t> m_tail{0};
+			std::size_t m_headSeen = 0;
+	};
+
+	/**
+	 * @class DecimalMpmcQueue
+	 * Bounded lock-free queue for any number of producer and consumer threads (D. Vyukov's bounded MPMC queue).
+	 *
+	 * Every slot carries a sequence number telling which lap of the ring it is ready for: a producer claims
+	 * position p by a CAS on the enqueue index once the slot's sequence equals p, writes the value and releases
+	 * sequence p + 1; a consumer claims p once the sequence equals p + 1, reads the value and releases
+	 * p + Capacity(), which hands the slot to the producer of the next lap. Producers and consumers only
+	 * contend among themselves, on their own index.
+	 */
+	template<typename T>
+	class DecimalMpmcQueue
+	{
+		public:
+			explicit DecimalMpmcQueue(std::size_t _capacity);
+
+			DecimalMpmcQueue(const DecimalMpmcQueue&) = delete;
+			DecimalMpmcQueue& operator=(const DecimalMpmcQueue&) = delete;
+
+			// Same contracts as DecimalSpscQueue, from any thread.
+			bool TryPush(T&& _value);
+			bool TryPop(T& _value);
+
+			void Push(T&& _value);
+			void Pop(T& _value);
+
+			std::size_t Capacity() const noexcept;
+
+		protected:
+			enum
+			{
+				kCacheLineSize = 64
+			};
+
+			struct Slot
+			{
+				std::atomic<std::size_t> m_sequence;
+				T m_value;
+			};
+
+			std::unique_ptr<Slot[]> m_slots;
+
+			std::size_t m_mask;
+
+			alignas(kCacheLineSize) std::atomic<std::size_t> m_enqueue{0};
+
+			alignas(kCacheLineSize) std::atomic<std::size_t> m_dequeue{0};
+	};
+
+	namespace queue
+	{
+		// Smallest power of two not less than _capacity (and not less than 2).
+		inline std::size_t RoundCapacity(std::size_t _capacity) noexcept
+		{
+			std::size_t capacity = 2;
+			while(capacity < _capacity)
+			{
+				capacity *= 2;
+			}
+
+			return capacity;
+		}
+	}
+}
+
+template<typename T>
+sav::DecimalSpscQueue<T>::DecimalSpscQueue(std::size_t _capacity)
+	:	m_slots(new T[queue::RoundCapacity(_capacity)]()),
+		m_mask(queue::RoundCapacity(_capacity) - 1)
+{
+
+}
+
+template<typename T>
+bool sav::DecimalSpscQueue<T>::TryPush(T&& _value)
+{
+	const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+	if(tail - m_headSeen > m_mask)
+	{
+		m_headSeen = m_head.load(std::memory_order_acquire);
+		if(tail - m_headSeen > m_mask)
+		{
+			return false;
+		}
+	}
+
+	m_slots[tail & m_mask] = std::move(_value);
+	m_tail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+template<typename T>
+bool sav::DecimalSpscQueue<T>::TryPop(T& _value)
+{
+	const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+	if(head == m_tailSeen)
+	{
+		m_tailSeen = m_tail.load(std::memory_order_acquire);
+		if(head == m_tailSeen)
+		{
+			return false;
+		}
+	}
+
+	_value = std::move(m_slots[head & m_mask]);
+	m_head.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+template<typename T>
+void sav::DecimalSpscQueue<T>::Push(T&& _value)
+{
+	while(!TryPush(std::move(_value)))
+	{
+		std::this_thread::yield();
+	}
+}
+
+template<typename T>
+void sav::DecimalSpscQueue<T>::Pop(T& _value)
+{
+	while(!TryPop(_value))
+	{
+		std::this_thread::yield();
+	}
+}
+
+template<typename T>
+std::size_t sav::DecimalSpscQueue<T>::Capacity() const noexcept
+{
+	return m_mask + 1;
+}
+
+template<typename T>
+sav::DecimalMpmcQueue<T>::DecimalMpmcQueue(std::size_t _capacity)
+	:	m_slots(new Slot[queue::RoundCapacity(_capacity)]()),
+		m_mask(queue::RoundCapacity(_capacity) - 1)
+{
+	for(std::size_t i = 0; i <= m_mask; i++)
+	{
+		m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template<typename T>
+bool sav::DecimalMpmcQueue<T>::TryPush(T&& _value)
+{
+	std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+
+	for(;;)
+	{
+		Slot& slot = m_slots[position & m_mask];
+		const std::size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+		const auto lap = static_cast<std::ptrdiff_t>(sequence - position);
+
+		if(lap == 0)
+		{
+			// The slot is free for this lap: claim the position (on failure position is reloaded).
+			if(m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				slot.m_value = std::move(_value);
+				slot.m_sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if(lap < 0)
+		{
+			// The slot still holds the value of the previous lap: full.
+			return false;
+		}
+		else
+		{
+			position = m_enqueue.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<typename T>
+bool sav::DecimalMpmcQueue<T>::TryPop(T& _value)
+{
+	std::size_t position = m_dequeue.load(std::memory_order_relaxed);
+
+	for(;;)
+	{
+		Slot& slot = m_slots[position & m_mask];
+		const std::size_t sequence = slot.m_sequence.load(std::memory_order_acquire);
+		const auto lap = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+		if(lap == 0)
+		{
+			if(m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				_value = std::move(slot.m_value);
+				slot.m_sequence.store(position + m_mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if(lap < 0)
+		{
+			// Not written yet: empty.
+			return false;
+		}
+		else
+		{
+			position = m_dequeue.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template<typename T>
+void sav::DecimalMpmcQueue<T>::Push(T&& _value)
+{
+	while(!TryPush(std::move(_value)))
+	{
+		std::this_thread::yield();
+	}
+}
+
+template<typename T>
+void sav::DecimalMpmcQueue<T>::Pop(T& _value)
+{
+	while(!TryPop(_value))
+	{
+		std::this_thread::yield();
+	}
+}
+
+template<typename T>
+std::size_t sav::DecimalMpmcQueue<T>::Capacity() const noexcept
+{
+	return m_mask + 1;
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALBOUNDEDQUEUE_H
@@ -0,0 +1,64 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALCHARCONV_H
+#define DECIMAL_VLN_BCD_DECIMALCHARCONV_H
+
+#include "Decimal.h"
+
+#include <charconv>
+#include <string_view>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * to_chars - write the base10 representation into a caller buffer, no string is allocated.
+	 * Values of up to 64 limbs (and below the base10 divide and conquer threshold, see DecimalThresholds)
+	 * are converted in stack scratch without any heap allocation; wider ones go through temporary limb vectors.
+	 * Same contract as std::to_chars: on success ptr is one past the last character written (no terminator);
+	 * if the buffer is too small, ec is std::errc::value_too_large, ptr is _last and the buffer content is unspecified.
+	 * @param _first
+	 * @param _last
+	 * @param _value
+	 */
+	std::to_chars_result to_chars(char* _first, char* _last, const Decimal& _value);
+
+	/**
+	 * from_chars - parse the longest sequence of base10 digits at _first.
+	 * Same contract as std::from_chars: ec is std::errc::invalid_argument if there is no digit
+	 * (_value is left unchanged), otherwise ptr is the first character which is not a digit.
+	 * @param _first
+	 * @param _last
+	 * @param _value receives the value, its storage is reused
+	 */
+	std::from_chars_result from_chars(const char* _first, const char* _last, Decimal& _value);
+	std::from_chars_result from_chars(std::string_view _text, Decimal& _value);
+
+	// Exact count of characters written by to_chars.
+	std::size_t to_chars_length(const Decimal& _value);
+
+	// Upper bound of to_chars_length computed from the storage size only, e.g. to size a buffer up front.
+	std::size_t to_chars_max_length(const Decimal& _value) noexcept;
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALCHARCONV_H
@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALCOLUMNREADER_H
+#define DECIMAL_VLN_BCD_DECIMALCOLUMNREADER_H
+
+#include "DecimalView.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * @class DecimalColumnReader
+	 * Reader of files written by DecimalColumnWriter.
+	 * The file is memory-mapped (read into memory where mmap is not available), nothing is parsed up front:
+	 * values are returned as DecimalView on the mapping, so loading a snapshot only costs the page faults
+	 * of the values actually touched. Views stay valid as long as the reader lives.
+	 */
+	class DecimalColumnReader
+	{
+		public:
+			/**
+			 * Constructor - map the file and validate its header.
+			 * @param _path
+			 */
+			explicit DecimalColumnReader(const std::string& _path);
+
+			~DecimalColumnReader();
+
+			DecimalColumnReader(const DecimalColumnReader&) = delete;
+			DecimalColumnReader& operator=(const DecimalColumnReader&) = delete;
+
+			// Returns false if the file could not be mapped or is not a valid column file, true otherwise
+			explicit operator bool() const noexcept;
+
+			// Error_IO if the file could not be opened or mapped, Error_InvalidArgument if its header is malformed.
+			DecimalStatus Status() const noexcept;
+
+			// Count of values.
+			std::uint64_t Size() const noexcept;
+
+			/**
+			 * operator[] - view on the value at _index.
+			 * An out of range _index or a corrupted overflow slot yields a view on zero, @see At to detect them.
+			 */
+			DecimalView operator[](std::uint64_t _index) const noexcept;
+
+			/**
+			 * At - checked access.
+			 * @param _index
+			 * @param _view receives the view on success
+			 * @return Ok, Error_InvalidArgument if _index is out of range or the slot is corrupted
+			 */
+			DecimalStatus At(std::uint64_t _index, DecimalView& _view) const noexcept;
+
+		protected:
+			const std::uint8_t* m_data = nullptr;
+
+			std::size_t m_size = 0;
+
+			// Fallback storage where mmap is not available.
+			std::vector<std::uint8_t> m_buffer;
+
+			std::uint64_t m_count = 0;
+
+			const std::uint8_t* m_heap = nullptr;
+
+			std::uint64_t m_heapSize = 0;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
+
+			// Validate the header and locate the slots and the heap.
+			DecimalStatus ReadHeader() noexcept;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALCOLUMNREADER_H
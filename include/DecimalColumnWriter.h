@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALCOLUMNWRITER_H
+#define DECIMAL_VLN_BCD_DECIMALCOLUMNWRITER_H
+
+#include "DecimalView.h"
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+namespace sav
+{
+	/**
+	 * @class DecimalColumnWriter
+	 * Streaming writer of the columnar snapshot format read by DecimalColumnReader.
+	 * Values up to 15 base256 digits (most amounts) go into fixed-width slots as they are appended;
+	 * larger ones go into an overflow heap which is kept in memory and written by Close().
+	 */
+	class DecimalColumnWriter
+	{
+		public:
+			/**
+			 * Constructor - create (truncate) the file.
+			 * @param _path
+			 */
+			explicit DecimalColumnWriter(const std::string& _path);
+
+			// Closes the file if Close() was not called.
+			~DecimalColumnWriter();
+
+			DecimalColumnWriter(const DecimalColumnWriter&) = delete;
+			DecimalColumnWriter& operator=(const DecimalColumnWriter&) = delete;
+
+			// Returns false if the file could not be created or written, true otherwise
+			explicit operator bool() const noexcept;
+
+			/**
+			 * Append - add the next value.
+			 * @return Ok, Error_IO on write failure, Error_InvalidArgument for an erroneous Decimal (which is not written)
+			 */
+			DecimalStatus Append(const Decimal& _value);
+			DecimalStatus Append(const DecimalView& _value);
+
+			/**
+			 * Close - write the overflow heap and the header. No values can be appended afterwards.
+			 * @return Ok or Error_IO
+			 */
+			DecimalStatus Close();
+
+			// Count of values appended so far.
+			std::uint64_t Count() const noexcept;
+
+		protected:
+			std::ofstream m_file;
+
+			std::vector<std::uint8_t> m_heap;
+
+			std::uint64_t m_count = 0;
+
+			bool m_closed = false;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALCOLUMNWRITER_H
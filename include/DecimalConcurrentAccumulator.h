@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALCONCURRENTACCUMULATOR_H
+#define DECIMAL_VLN_BCD_DECIMALCONCURRENTACCUMULATOR_H
+
+#include "Decimal.h"
+#include "DecimalAccumulator.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace sav
+{
+	/**
+	 * @class DecimalConcurrentAccumulator
+	 * Running sum which many threads can add into without locking.
+	 *
+	 * The sum is split into shards, each thread adds into its own shard (threads are spread over
+	 * shards round-robin on their first addition), and shards are merged only when the value is read.
+	 * Every shard keeps a fixed number of 64-bit limb columns, each with a carry column next to it:
+	 * a limb of an addend is one relaxed atomic addition to its column, and a wrap of the column
+	 * (seen from the value fetch_add returns) one more to the carry column. Columns of all shards
+	 * live in one cache-line aligned allocation, padded so that no two shards share a cache line.
+	 *
+	 * Memory ordering:
+	 * - Add() announces itself in the shard's "started" counter, issues a release fence, adds its
+	 *   limbs to the columns and then increments "finished" with release semantics.
+	 * - Value() reads "finished" with acquire semantics, then the columns, then (after an acquire fence)
+	 *   "started". A shard is accepted only if both counters match, i.e. no addition to it was in flight;
+	 *   otherwise it is read again.
+	 * - Hence Value() includes every Add() that happens-before it, and every concurrent Add() is included
+	 *   either completely or not at all.
+	 *
+	 * Progress: Value() is not wait-free. Writers which keep a shard busy could make every read of it fail,
+	 * so after kOptimisticReads failed reads Value() raises the shard's "waiting readers" count. Add() does
+	 * not announce itself to a shard with waiting readers (it yields until they are gone), hence the read
+	 * only waits for the additions already in flight. Add() waits for nothing else.
+	 *
+	 * Addends wider than the columns fall back to a mutex-protected DecimalAccumulator.
+	 */
+	class DecimalConcurrentAccumulator
+	{
+		public:
+			/**
+			 * Constructor for an empty (zero) sum.
+			 * @param _shards count of shards, 0 means one per hardware thread
+			 * @param _digits count of base256 digits every shard can hold without falling back to a lock
+			 */
+			explicit DecimalConcurrentAccumulator(std::size_t _shards = 0, std::size_t _digits = kDefaultDigits);
+
+			DecimalConcurrentAccumulator(const DecimalConcurrentAccumulator&) = delete;
+			DecimalConcurrentAccumulator& operator=(const DecimalConcurrentAccumulator&) = delete;
+
+			// Thread-safe additions, lock-free unless a reader holds the shard back (see Progress above).
+			void Add(const Decimal& _addend);
+			void Add(std::uint64_t _addend);
+
+			DecimalConcurrentAccumulator& operator+=(const Decimal& _addend);
+			DecimalConcurrentAccumulator& operator+=(std::uint64_t _addend);
+
+			/**
+			 * Value - merge the shards and return the sum. Thread-safe.
+			 * @return normalized sum, or a Decimal with error status if any addend had one
+			 */
+			Decimal Value() const;
+
+			// Reset the sum to zero. Must not run concurrently with Add().
+			void Reset();
+
+		protected:
+			enum
+			{
+				kDefaultDigits = 32,
+				kCacheLineSize = 64,
+				kLineColumns = kCacheLineSize / sizeof(std::uint64_t),
+				kOptimisticReads = 64
+			};
+
+			struct alignas(kCacheLineSize) Shard
+			{
+				std::atomic<std::uint64_t> m_started{0};
+				std::atomic<std::uint64_t> m_finished{0};
+
+				// Count of Value() calls which gave up reading the shard optimistically.
+				mutable std::atomic<std::uint32_t> m_waitingReaders{0};
+			};
+
+			// One cache line of columns.
+			struct alignas(kCacheLineSize) ColumnLine
+			{
+				std::atomic<std::uint64_t> m_columns[kLineColumns];
+			};
+
+			// Count of 64-bit limbs every shard holds.
+			std::size_t m_limbs;
+
+			// Count of column lines of a shard: its m_limbs limb columns, then as many carry columns, padded to whole lines.
+			std::size_t m_shardLines;
+
+			std::vector<Shard> m_shards;
+
+			// Columns of all shards, those of shard i start at line i * m_shardLines.
+			std::unique_ptr<ColumnLine[]> m_lines;
+
+			std::atomic<DecimalStatus> m_status{DecimalStatus::Ok};
+
+			// Addends which do not fit into shard columns.
+			mutable std::mutex m_overflowMutex;
+			DecimalAccumulator m_overflow;
+
+			// Index of the shard of the calling thread.
+			std::size_t CurrentShard() const;
+
+			// Column _column of shard _shard, carry columns follow the m_limbs limb columns.
+			std::atomic<std::uint64_t>& Column(std::size_t _shard, std::size_t _column) const;
+
+			// Announce an addition to the shard of the calling thread, @return the shard index for AddLimb and EndAddition.
+			std::size_t BeginAddition();
+			void EndAddition(std::size_t _shard);
+
+			/**
+			 * AddLimb - add a 64-bit limb to a column of an announced addition.
+			 * @param _shard
+			 * @param _limb index of the column
+			 * @param _value
+			 */
+			void AddLimb(std::size_t _shard, std::size_t _limb, std::uint64_t _value);
+
+			/**
+			 * ReadShard - read the columns of a shard if no addition to it is in flight.
+			 * @param _shard
+			 * @param _limbs receives the m_limbs limb columns
+			 * @param _carries receives the m_limbs carry columns
+			 * @return true if the columns were read consistently, false if they have to be read again
+			 */
+			bool ReadShard(std::size_t _shard, std::vector<std::uint64_t>& _limbs, std::vector<std::uint64_t>& _carries) const;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALCONCURRENTACCUMULATOR_H
@@ -0,0 +1,49 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALDOTPRODUCT_H
+#define DECIMAL_VLN_BCD_DECIMALDOTPRODUCT_H
+
+#include "Decimal.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace sav
+{
+	/**
+	 * DotProduct - sum of pairwise products, e.g. sum of price * quantity over receipt positions.
+	 * Products are accumulated digit by digit into a DecimalAccumulator, no product is ever materialized.
+	 * @param _lhs
+	 * @param _rhs
+	 * @param _count count of pairs
+	 * @return sum of _lhs[i] * _rhs[i], or a Decimal with error status if any multiplier had one
+	 */
+	Decimal DotProduct(const Decimal* _lhs, const Decimal* _rhs, std::size_t _count);
+	Decimal DotProduct(const Decimal* _lhs, const std::uint64_t* _rhs, std::size_t _count);
+
+	// Same as above, returns a Decimal with Error_InvalidArgument status if sizes differ.
+	Decimal DotProduct(const std::vector<Decimal>& _lhs, const std::vector<Decimal>& _rhs);
+	Decimal DotProduct(const std::vector<Decimal>& _lhs, const std::vector<std::uint64_t>& _rhs);
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALDOTPRODUCT_H
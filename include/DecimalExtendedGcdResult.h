@@ -0,0 +1,62 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALEXTENDEDGCDRESULT_H
+#define DECIMAL_VLN_BCD_DECIMALEXTENDEDGCDRESULT_H
+
+#include "Decimal.h"
+
+namespace sav
+{
+	/**
+	 * @class DecimalExtendedGcdResult
+	 * Extended GCD result class - greatest common divisor, Bezout coefficients and status.
+	 * The coefficients satisfy
+	 * a * CoefficientA - b * CoefficientB == Gcd, if CoefficientANegative is false,
+	 * b * CoefficientB - a * CoefficientA == Gcd, otherwise.
+	 */
+	class DecimalExtendedGcdResult
+	{
+		friend class Decimal;
+
+	public:
+		// Returns true if both operands were coherent, false otherwise
+		explicit operator bool() const noexcept;
+
+		// Greatest common divisor
+		Decimal Gcd;
+
+		// Bezout coefficient of the first operand (magnitude)
+		Decimal CoefficientA;
+
+		// Bezout coefficient of the second operand (magnitude)
+		Decimal CoefficientB;
+
+		// Sign of the first operand's coefficient (the second one always has the opposite sign)
+		bool CoefficientANegative = false;
+
+	protected:
+		DecimalStatus m_status = DecimalStatus::Ok;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALEXTENDEDGCDRESULT_H
@@ -0,0 +1,216 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALINLINE_H
+#define DECIMAL_VLN_BCD_DECIMALINLINE_H
+
+#include "Decimal.h"
+#include "DecimalInstrumentation.h"
+
+#include <algorithm>
+
+/**
+ * Small-value fast paths of Decimal: construction, comparison, +, - and * of single-limb values
+ * (e.g. money amounts), which work on native integers instead of limb vectors.
+ *
+ * With DECIMAL_VLN_BCD_INLINE defined (CMake option Decimal_VLN_BCD_INLINE, on by default) Decimal.h includes
+ * this file and the definitions are inline, so they are visible to the compiler at every call site.
+ * Otherwise they are compiled once into Decimal.cpp. The definition is public on the library target,
+ * so the library and its users always agree on which of the two it is.
+ */
+#ifdef DECIMAL_VLN_BCD_INLINE
+#define DECIMAL_VLN_BCD_INLINE_DEFINITION inline
+#else
+#define DECIMAL_VLN_BCD_INLINE_DEFINITION
+#endif
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal::Decimal(std::uint64_t _initial)
+{
+	instrumentation::Scope scope{DecimalOperation::Construct, sizeof(_initial)};
+
+	// Zero is the default digits, which need no buffer.
+	if(_initial == 0)
+	{
+		return;
+	}
+
+	// The most significant digit of a non-zero value is not zero and there is no whole zero limb below it: normalized.
+	std::vector<std::uint8_t> digits;
+	digits.reserve(sizeof(_initial));
+
+	for(; _initial != 0; _initial >>= 8)
+	{
+		digits.push_back(static_cast<std::uint8_t>(_initial));
+	}
+
+	m_digits = std::move(digits);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::EqualsZero() const noexcept
+{
+	return m_digits.size() == 1 && m_digits[0] == 0x00;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator==(const sav::Decimal& _rhs) const noexcept
+{
+	instrumentation::Scope scope{DecimalOperation::Compare, std::max(DigitCount(), _rhs.DigitCount())};
+
+	// Both sides are normalized, equal values are stored the same way.
+	return this->m_zeroLimbs == _rhs.m_zeroLimbs && this->m_digits == _rhs.m_digits;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator!=(const sav::Decimal& _rhs) const noexcept
+{
+	return !((*this) == _rhs);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator<(const sav::Decimal& _rhs) const noexcept
+{
+	return Compare(_rhs) < 0;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator>(const sav::Decimal& _rhs) const noexcept
+{
+	return Compare(_rhs) > 0;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator<=(const sav::Decimal& _rhs) const noexcept
+{
+	return Compare(_rhs) <= 0;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::operator>=(const sav::Decimal& _rhs) const noexcept
+{
+	return Compare(_rhs) >= 0;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal sav::Decimal::operator+(const sav::Decimal& _rhs) const
+{
+	instrumentation::Scope scope{DecimalOperation::Add, std::max(DigitCount(), _rhs.DigitCount())};
+
+	if(SingleLimb() && _rhs.SingleLimb())
+	{
+		const std::uint64_t lhs = SingleLimbValue();
+		const std::uint64_t sum = lhs + _rhs.SingleLimbValue();
+
+		// no carry out of the limb
+		if(sum >= lhs)
+		{
+			return Decimal{sum};
+		}
+	}
+
+	return AddLimbs(_rhs);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal sav::Decimal::operator-(const sav::Decimal& _rhs) const
+{
+	instrumentation::Scope scope{DecimalOperation::Subtract, std::max(DigitCount(), _rhs.DigitCount())};
+
+	// An underflow is left to the general path, which sets the status.
+	if(SingleLimb() && _rhs.SingleLimb() && SingleLimbValue() >= _rhs.SingleLimbValue())
+	{
+		return Decimal{SingleLimbValue() - _rhs.SingleLimbValue()};
+	}
+
+	return SubtractLimbs(_rhs);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal sav::Decimal::operator*(const sav::Decimal& _rhs) const
+{
+	instrumentation::Scope scope{DecimalOperation::Multiply, std::max(DigitCount(), _rhs.DigitCount())};
+
+	// A product has at most as many digits as both factors together.
+	if(SingleLimb() && _rhs.SingleLimb() && m_digits.size() + _rhs.m_digits.size() <= sizeof(std::uint64_t))
+	{
+		return Decimal{SingleLimbValue() * _rhs.SingleLimbValue()};
+	}
+
+	return MultiplyLimbs(_rhs);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal& sav::Decimal::operator+=(const sav::Decimal& _rhs)
+{
+	(*this) = (*this) + _rhs;
+
+	return (*this);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal& sav::Decimal::operator-=(const sav::Decimal& _rhs)
+{
+	(*this) = (*this) - _rhs;
+
+	return (*this);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION sav::Decimal& sav::Decimal::operator*=(const sav::Decimal& _rhs)
+{
+	(*this) = (*this) * _rhs;
+
+	return (*this);
+}
+
+// Size argument of the instrumentation scopes: defined here so that it folds away with them when instrumentation is off.
+DECIMAL_VLN_BCD_INLINE_DEFINITION std::size_t sav::Decimal::DigitCount() const
+{
+	return m_digits.size() + m_zeroLimbs * sizeof(std::uint64_t);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION bool sav::Decimal::SingleLimb() const
+{
+	return m_zeroLimbs == 0 && m_digits.size() <= sizeof(std::uint64_t);
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION std::uint64_t sav::Decimal::SingleLimbValue() const
+{
+	const std::uint8_t* digits = m_digits.data();
+
+	std::uint64_t value = 0;
+	for(std::size_t i = m_digits.size(); i-- > 0; )
+	{
+		value = (value << 8) | digits[i];
+	}
+
+	return value;
+}
+
+DECIMAL_VLN_BCD_INLINE_DEFINITION int sav::Decimal::Compare(const sav::Decimal& _rhs) const
+{
+	instrumentation::Scope scope{DecimalOperation::Compare, std::max(DigitCount(), _rhs.DigitCount())};
+
+	if(SingleLimb() && _rhs.SingleLimb())
+	{
+		const std::uint64_t lhs = SingleLimbValue();
+		const std::uint64_t rhs = _rhs.SingleLimbValue();
+
+		return lhs < rhs ? -1 : (lhs > rhs ? 1 : 0);
+	}
+
+	return CompareLimbs(_rhs);
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALINLINE_H
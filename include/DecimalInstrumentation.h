@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALINSTRUMENTATION_H
+#define DECIMAL_VLN_BCD_DECIMALINSTRUMENTATION_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	// Instrumented operations.
+	enum class DecimalOperation
+	{
+		Construct,
+		SetFromString,
+		ToString,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		DivideAndRound,
+		DivExact,
+		Square,
+		Pow,
+		Gcd,
+		Compare,
+
+		Count
+	};
+
+	/**
+	 * @class DecimalOperationCounters
+	 * Counters of one operation.
+	 */
+	class DecimalOperationCounters
+	{
+		public:
+			enum : std::size_t
+			{
+				// Bucket i counts operands of 2^i .. 2^(i+1) - 1 limbs, the last one everything above.
+				kHistogramBuckets = 16
+			};
+
+			std::uint64_t Calls = 0;
+
+			// Time stamp counter ticks on x86, nanoseconds elsewhere; nested operations are included.
+			std::uint64_t Cycles = 0;
+
+			// Length of the widest operand in 64-bit limbs.
+			std::array<std::uint64_t, kHistogramBuckets> LimbHistogram{};
+	};
+
+	/**
+	 * @class DecimalInstrumentationSnapshot
+	 * Counters of all threads at one point in time.
+	 */
+	class DecimalInstrumentationSnapshot
+	{
+		public:
+			const DecimalOperationCounters& operator[](DecimalOperation _operation) const noexcept;
+
+			std::array<DecimalOperationCounters, static_cast<std::size_t>(DecimalOperation::Count)> Operations{};
+
+			// Digit buffers allocated, and how many of them were copy-on-write copies of a shared buffer.
+			std::uint64_t BufferAllocations = 0;
+			std::uint64_t BufferCopies = 0;
+	};
+
+	/**
+	 * @class DecimalInstrumentation
+	 * Opt-in operation counters, compiled in with the DECIMAL_VLN_BCD_INSTRUMENTATION definition
+	 * (CMake option Decimal_VLN_BCD_INSTRUMENTATION). Otherwise every hook is empty and snapshots are zero.
+	 * Every thread counts into its own counters without synchronization; snapshots add them up.
+	 */
+	class DecimalInstrumentation
+	{
+		public:
+			// Returns true if the counters are compiled in.
+			static bool Enabled() noexcept;
+
+			static DecimalInstrumentationSnapshot Snapshot();
+
+			// Zero all counters. Exact only while no other thread runs Decimal operations.
+			static void Reset();
+
+			static const char* Name(DecimalOperation _operation) noexcept;
+	};
+
+	// Hooks called by the library.
+	namespace instrumentation
+	{
+#ifdef DECIMAL_VLN_BCD_INSTRUMENTATION
+		void CountBuffer(bool _copy) noexcept;
+
+		/**
+		 * @class Scope
+		 * Counts one call of an operation and its duration.
+		 */
+		class Scope
+		{
+			public:
+				Scope(DecimalOperation _operation, std::size_t _digits) noexcept;
+				~Scope();
+
+				Scope(const Scope&) = delete;
+				Scope& operator=(const Scope&) = delete;
+
+			protected:
+				DecimalOperation m_operation;
+
+				std::uint64_t m_start;
+		};
+#else
+		inline void CountBuffer(bool) noexcept
+		{
+
+		}
+
+		class Scope
+		{
+			public:
+				Scope(DecimalOperation, std::size_t) noexcept
+				{
+
+				}
+		};
+#endif
+	}
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALINSTRUMENTATION_H
@@ -34,6 +34,7 @@ namespace sav
 	class DecimalIntegerDivisionResult
 	{
 		friend class Decimal;
+		friend class DecimalView;
 
 	public:
 		// Returns true on coherent division, false otherwise (for example, if divided by zero)
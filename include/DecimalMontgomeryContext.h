@@ -0,0 +1,106 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALMONTGOMERYCONTEXT_H
+#define DECIMAL_VLN_BCD_DECIMALMONTGOMERYCONTEXT_H
+
+#include "Decimal.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace sav
+{
+	/**
+	 * @class DecimalMontgomeryContext
+	 * Modular arithmetic for a fixed odd modulus N in Montgomery form (x -> x * R mod N, R = 2^(64 * limbs of N)).
+	 * Montgomery multiplication reduces without any division, so MulMod and PowMod avoid operator/ entirely
+	 * (apart from the one-time setup and reduction of out-of-range arguments).
+	 */
+	class DecimalMontgomeryContext
+	{
+		public:
+			/**
+			 * Constructor for a modulus.
+			 * @param _modulus odd and greater than 1, otherwise the context gets Error_InvalidArgument status
+			 */
+			explicit DecimalMontgomeryContext(const Decimal& _modulus);
+
+			// Returns false if the modulus was not valid, true otherwise
+			explicit operator bool() const noexcept;
+
+			const Decimal& Modulus() const noexcept;
+
+			// Conversion into and out of Montgomery form: _value * R mod N, _value / R mod N.
+			Decimal ToMontgomery(const Decimal& _value) const;
+			Decimal FromMontgomery(const Decimal& _value) const;
+
+			/**
+			 * MontgomeryMul - multiply two values which are already in Montgomery form.
+			 * @return _lhs * _rhs / R mod N, i.e. the product in Montgomery form
+			 */
+			Decimal MontgomeryMul(const Decimal& _lhs, const Decimal& _rhs) const;
+
+			// _lhs * _rhs mod N for ordinary (not Montgomery form) values.
+			Decimal MulMod(const Decimal& _lhs, const Decimal& _rhs) const;
+
+			/**
+			 * PowMod - modular exponentiation with a sliding window over the exponent bits.
+			 * @param _base ordinary (not Montgomery form) value
+			 * @param _exponent
+			 * @return _base ^ _exponent mod N
+			 */
+			Decimal PowMod(const Decimal& _base, const Decimal& _exponent) const;
+
+		protected:
+			using Limb = std::uint64_t;
+
+			Decimal m_modulusDecimal;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
+
+			// Modulus in 64-bit limbs, all Montgomery form values have exactly as many limbs.
+			std::vector<Limb> m_modulus;
+
+			// -N^-1 mod 2^64
+			Limb m_inverse = 0;
+
+			// R^2 mod N, for conversion into Montgomery form.
+			std::vector<Limb> m_rSquared;
+
+			// R mod N, i.e. 1 in Montgomery form.
+			std::vector<Limb> m_one;
+
+			// Value reduced modulo N, as m_modulus.size() limbs.
+			std::vector<Limb> Reduce(const Decimal& _value) const;
+
+			// Montgomery multiplication (CIOS), operands and result have m_modulus.size() limbs.
+			std::vector<Limb> Multiply(const std::vector<Limb>& _lhs, const std::vector<Limb>& _rhs) const;
+
+			// Result with Error_InvalidArgument status for an invalid context.
+			static Decimal InvalidResult();
+
+			static Decimal ToDecimal(const std::vector<Limb>& _limbs);
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALMONTGOMERYCONTEXT_H
@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALRECEIPTPIPELINE_H
+#define DECIMAL_VLN_BCD_DECIMALRECEIPTPIPELINE_H
+
+#include "Decimal.h"
+
+#include <array>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * @class DecimalReceiptPipeline
+	 * Receipt processing (the VATTests workload) split into stages running on their own threads:
+	 * parse -> compute -> aggregate -> format.
+	 *
+	 * Input is one receipt per line: prices of the positions with VAT included, in minor units, separated
+	 * by the delimiter. A position may carry its own VAT rate in percent after a '/' (e.g. "10000,2500/10"),
+	 * otherwise the default rate applies. Spaces, tabs and '\r' around a position are ignored, a blank line is an empty receipt.
+	 * Output is one "total<delimiter>vat" line per receipt, in input order, where vat is the sum over the positions
+	 * of price * rate / (100 + rate) rounded half up.
+	 *
+	 * Receipts travel in batches through bounded lock-free queues (@see DecimalBoundedQueue.h): multi-producer/
+	 * multi-consumer queues around the compute workers and a single producer/single consumer one from the aggregate
+	 * to the format stage. A full queue blocks its producer. Batches leave the compute workers out of order and are
+	 * put back in order by the aggregate stage, which holds back the ones that overtook an earlier batch. The queues
+	 * do not bound those, so the parse stage also takes a credit for every batch, which the format stage returns
+	 * once the batch is written: at most ComputeThreads + 2 * QueueCapacity batches are in flight whatever the
+	 * relative stage speeds.
+	 */
+	class DecimalReceiptPipeline
+	{
+		public:
+			struct Options
+			{
+				// Receipts per batch.
+				std::size_t BatchSize = 256;
+				// Batches every queue can hold.
+				std::size_t QueueCapacity = 8;
+				// Threads of the compute stage.
+				std::size_t ComputeThreads = 1;
+				// VAT rate in percent of the positions without their own.
+				unsigned int DefaultRate = 20;
+				char Delimiter = ',';
+			};
+
+			enum class Stage
+			{
+				Parse,
+				Compute,
+				Aggregate,
+				Format,
+				Count
+			};
+
+			struct StageStatistics
+			{
+				std::uint64_t Batches = 0;
+				std::uint64_t Receipts = 0;
+				// Time spent on batches, and time blocked on an empty input or a full output queue (all threads of the stage).
+				std::uint64_t BusyNanoseconds = 0;
+				std::uint64_t StalledNanoseconds = 0;
+				// Longest time spent on a single batch.
+				std::uint64_t MaxBatchNanoseconds = 0;
+
+				// Receipts per second of busy time, i.e. per thread of the stage.
+				double Throughput() const noexcept;
+			};
+
+			// Constructor with default options.
+			explicit DecimalReceiptPipeline();
+
+			explicit DecimalReceiptPipeline(const Options& _options);
+
+			/**
+			 * Run - process every receipt of the input; the calling thread runs the format stage.
+			 * @param _input
+			 * @param _output
+			 * @return Ok, Error_InvalidArgument if a line is not a receipt (the receipts before it are written,
+			 * @see Receipts), Error_IO if reading or writing failed
+			 */
+			DecimalStatus Run(std::istream& _input, std::ostream& _output);
+
+			// Count of receipts written by the last Run.
+			std::uint64_t Receipts() const noexcept;
+
+			// Statistics of the last Run.
+			const StageStatistics& Statistics(Stage _stage) const noexcept;
+
+			// Time from the start of parsing a batch until it is written, over the batches of the last Run.
+			std::uint64_t MeanLatencyNanoseconds() const noexcept;
+			std::uint64_t MaxLatencyNanoseconds() const noexcept;
+
+			// Most batches the aggregate stage held back at once during the last Run (bounded by the credits, see above).
+			std::size_t MaxReorderedBatches() const noexcept;
+
+			static const char* Name(Stage _stage) noexcept;
+
+		protected:
+			Options m_options;
+
+			std::array<StageStatistics, static_cast<std::size_t>(Stage::Count)> m_statistics;
+
+			std::uint64_t m_receipts = 0;
+
+			std::uint64_t m_latencySum = 0;
+
+			std::uint64_t m_latencyMax = 0;
+
+			std::size_t m_maxReordered = 0;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALRECEIPTPIPELINE_H
@@ -0,0 +1,50 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALROUNDINGMODE_H
+#define DECIMAL_VLN_BCD_DECIMALROUNDINGMODE_H
+
+namespace sav
+{
+	/**
+	 * @enum class DecimalRoundingMode
+	 * How a quotient is rounded to an integer (values are non-negative, so Ceiling rounds up
+	 * and Floor is the same as Truncate).
+	 */
+	enum class DecimalRoundingMode
+	{
+		// Nearest, ties away from zero (the 4/5 rule).
+		HalfUp,
+		// Nearest, ties to the even quotient (banker's rounding).
+		HalfEven,
+		// Nearest, ties towards zero.
+		HalfDown,
+		// Up unless exact.
+		Ceiling,
+		// Down.
+		Floor,
+		// Down.
+		Truncate
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALROUNDINGMODE_H
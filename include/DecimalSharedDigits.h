@@ -0,0 +1,444 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALSHAREDDIGITS_H
+#define DECIMAL_VLN_BCD_DECIMALSHAREDDIGITS_H
+
+#include "DecimalInstrumentation.h"
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * @class DecimalSharedDigits
+	 * Reference-counted digit storage of Decimal with copy-on-write.
+	 * Copies share the buffer in O(1); the buffer is copied only when a shared one is about to be modified.
+	 * Read access goes through the const members (or the conversion to const std::vector&), write access through
+	 * the non-const ones, which detach first.
+	 * Reference counts are atomic: copies sharing a buffer may be used (and modified) from different threads,
+	 * a single object still may not be modified concurrently, same as std::shared_ptr.
+	 * Without a buffer (default-constructed or moved-from) the digits read as the single digit 0, so zero
+	 * values neither allocate nor touch a shared reference count.
+	 * A buffer may also carry the base10 text of its value (@see CachedText), which is dropped by any write access.
+	 * Accessors are defined inline, they are on the hot path of every digit loop.
+	 */
+	class DecimalSharedDigits
+	{
+		public:
+			using Digits = std::vector<std::uint8_t>;
+			using iterator = Digits::iterator;
+			using const_iterator = Digits::const_iterator;
+
+			// Constructor for the digit 0 (nothing is allocated).
+			DecimalSharedDigits() noexcept = default;
+
+			// Constructor taking over digits.
+			DecimalSharedDigits(Digits&& _digits);
+
+			DecimalSharedDigits(const DecimalSharedDigits& _other) noexcept;
+			DecimalSharedDigits(DecimalSharedDigits&& _other) noexcept;
+
+			DecimalSharedDigits& operator=(const DecimalSharedDigits& _other) noexcept;
+			DecimalSharedDigits& operator=(DecimalSharedDigits&& _other) noexcept;
+
+			// Replace the digits, reusing the buffer if it is not shared.
+			DecimalSharedDigits& operator=(Digits&& _digits);
+
+			~DecimalSharedDigits();
+
+			// Read access, never copies.
+			operator const Digits&() const noexcept;
+
+			std::size_t size() const noexcept;
+			bool empty() const noexcept;
+
+			const std::uint8_t& operator[](std::size_t _index) const noexcept;
+			const std::uint8_t* data() const noexcept;
+
+			const_iterator begin() const noexcept;
+			const_iterator end() const noexcept;
+
+			const std::uint8_t& front() const noexcept;
+			const std::uint8_t& back() const noexcept;
+
+			// Equal digits, O(1) for a shared buffer.
+			bool operator==(const DecimalSharedDigits& _rhs) const noexcept;
+
+			// Returns true if another object shares the buffer.
+			bool Shared() const noexcept;
+
+			/**
+			 * CachedText - base10 text stored by CacheText for these digits with _zeroLimbs implicit zero limbs.
+			 * @return the text, valid until the buffer is modified or released, or nullptr if there is none
+			 */
+			const std::string* CachedText(std::size_t _zeroLimbs) const noexcept;
+
+			/**
+			 * CacheText - store the base10 text of the value, shared by every copy of the buffer.
+			 * Thread-safe: the first text stored for a buffer is kept, later ones are ignored.
+			 */
+			void CacheText(std::size_t _zeroLimbs, const std::string& _text) const;
+
+			// Write access, the buffer is copied first if it is shared.
+			Digits& Mutable();
+
+			std::uint8_t& operator[](std::size_t _index);
+			std::uint8_t* data();
+
+			iterator begin();
+			iterator end();
+
+			std::uint8_t& back();
+
+			void push_back(std::uint8_t _digit);
+			void pop_back();
+			void resize(std::size_t _size);
+			void reserve(std::size_t _capacity);
+
+			template<typename... Arguments>
+			iterator insert(const_iterator _position, Arguments&&... _arguments);
+
+			// clear() and assign() of a shared buffer start from a new one instead of copying.
+			void clear();
+
+			template<typename... Arguments>
+			void assign(Arguments&&... _arguments);
+
+		protected:
+			struct Text
+			{
+				std::size_t m_zeroLimbs;
+				std::string m_text;
+			};
+
+			struct Block
+			{
+				std::atomic<std::size_t> m_references{1};
+
+				Digits m_digits;
+
+				std::atomic<const Text*> m_text{nullptr};
+
+				~Block()
+				{
+					delete m_text.load(std::memory_order_relaxed);
+				}
+			};
+
+			Block* m_block = nullptr;
+
+			// Digits read without a buffer.
+			static const Digits& Zero() noexcept;
+
+			void Release() noexcept;
+
+			// Make the buffer unique (allocated if there is none), copying it if it is shared.
+			void Detach();
+
+			// Make the buffer unique without keeping its content.
+			void Discard();
+
+			// Drop the cached text of a unique buffer which is about to be modified.
+			void DropText() noexcept;
+	};
+}
+
+inline const sav::DecimalSharedDigits::Digits& sav::DecimalSharedDigits::Zero() noexcept
+{
+	static const Digits zero{0x00};
+	return zero;
+}
+
+inline void sav::DecimalSharedDigits::Release() noexcept
+{
+	if(m_block != nullptr && m_block->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		delete m_block;
+	}
+
+	m_block = nullptr;
+}
+
+inline void sav::DecimalSharedDigits::Detach()
+{
+	// Acquire pairs with the release of the other owners, so that their reads happen before our writes.
+	if(m_block != nullptr && m_block->m_references.load(std::memory_order_acquire) == 1)
+	{
+		DropText();
+		return;
+	}
+
+	Block* block = new Block;
+	block->m_digits = static_cast<const Digits&>(*this);
+
+	instrumentation::CountBuffer(m_block != nullptr);
+
+	Release();
+	m_block = block;
+}
+
+inline void sav::DecimalSharedDigits::Discard()
+{
+	if(m_block != nullptr && m_block->m_references.load(std::memory_order_acquire) == 1)
+	{
+		DropText();
+		return;
+	}
+
+	Release();
+	m_block = new Block;
+
+	instrumentation::CountBuffer(false);
+}
+
+inline void sav::DecimalSharedDigits::DropText() noexcept
+{
+	// Write access is on the hot path of digit loops: a plain load unless there is a text to drop.
+	if(m_block->m_text.load(std::memory_order_relaxed) != nullptr)
+	{
+		delete m_block->m_text.exchange(nullptr, std::memory_order_relaxed);
+	}
+}
+
+inline sav::DecimalSharedDigits::DecimalSharedDigits(Digits&& _digits)
+	:	m_block(new Block)
+{
+	m_block->m_digits = std::move(_digits);
+
+	instrumentation::CountBuffer(false);
+}
+
+inline sav::DecimalSharedDigits::DecimalSharedDigits(const DecimalSharedDigits& _other) noexcept
+	:	m_block(_other.m_block)
+{
+	if(m_block != nullptr)
+	{
+		m_block->m_references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+inline sav::DecimalSharedDigits::DecimalSharedDigits(DecimalSharedDigits&& _other) noexcept
+	:	m_block(std::exchange(_other.m_block, nullptr))
+{
+
+}
+
+inline sav::DecimalSharedDigits& sav::DecimalSharedDigits::operator=(const DecimalSharedDigits& _other) noexcept
+{
+	if(m_block != _other.m_block)
+	{
+		DecimalSharedDigits copy{_other};
+		std::swap(m_block, copy.m_block);
+	}
+
+	return (*this);
+}
+
+inline sav::DecimalSharedDigits& sav::DecimalSharedDigits::operator=(DecimalSharedDigits&& _other) noexcept
+{
+	if(this != &_other)
+	{
+		Release();
+		m_block = std::exchange(_other.m_block, nullptr);
+	}
+
+	return (*this);
+}
+
+inline sav::DecimalSharedDigits& sav::DecimalSharedDigits::operator=(Digits&& _digits)
+{
+	Discard();
+	m_block->m_digits = std::move(_digits);
+
+	return (*this);
+}
+
+inline sav::DecimalSharedDigits::~DecimalSharedDigits()
+{
+	Release();
+}
+
+inline sav::DecimalSharedDigits::operator const Digits&() const noexcept
+{
+	return m_block != nullptr ? m_block->m_digits : Zero();
+}
+
+inline std::size_t sav::DecimalSharedDigits::size() const noexcept
+{
+	return m_block != nullptr ? m_block->m_digits.size() : 1;
+}
+
+inline bool sav::DecimalSharedDigits::empty() const noexcept
+{
+	return size() == 0;
+}
+
+inline const std::uint8_t& sav::DecimalSharedDigits::operator[](std::size_t _index) const noexcept
+{
+	return static_cast<const Digits&>(*this)[_index];
+}
+
+inline const std::uint8_t* sav::DecimalSharedDigits::data() const noexcept
+{
+	return static_cast<const Digits&>(*this).data();
+}
+
+inline sav::DecimalSharedDigits::const_iterator sav::DecimalSharedDigits::begin() const noexcept
+{
+	return static_cast<const Digits&>(*this).begin();
+}
+
+inline sav::DecimalSharedDigits::const_iterator sav::DecimalSharedDigits::end() const noexcept
+{
+	return static_cast<const Digits&>(*this).end();
+}
+
+inline const std::uint8_t& sav::DecimalSharedDigits::front() const noexcept
+{
+	return static_cast<const Digits&>(*this).front();
+}
+
+inline const std::uint8_t& sav::DecimalSharedDigits::back() const noexcept
+{
+	return static_cast<const Digits&>(*this).back();
+}
+
+inline bool sav::DecimalSharedDigits::operator==(const DecimalSharedDigits& _rhs) const noexcept
+{
+	return m_block == _rhs.m_block || static_cast<const Digits&>(*this) == static_cast<const Digits&>(_rhs);
+}
+
+inline bool sav::DecimalSharedDigits::Shared() const noexcept
+{
+	return m_block != nullptr && m_block->m_references.load(std::memory_order_acquire) != 1;
+}
+
+inline const std::string* sav::DecimalSharedDigits::CachedText(std::size_t _zeroLimbs) const noexcept
+{
+	if(m_block == nullptr)
+	{
+		return nullptr;
+	}
+
+	// Acquire pairs with the release in CacheText, the text is completely written before it is seen.
+	const Text* text = m_block->m_text.load(std::memory_order_acquire);
+
+	return text != nullptr && text->m_zeroLimbs == _zeroLimbs ? &text->m_text : nullptr;
+}
+
+inline void sav::DecimalSharedDigits::CacheText(std::size_t _zeroLimbs, const std::string& _text) const
+{
+	if(m_block == nullptr)
+	{
+		return;
+	}
+
+	const Text* text = new Text{_zeroLimbs, _text};
+	const Text* expected = nullptr;
+
+	if(!m_block->m_text.compare_exchange_strong(expected, text, std::memory_order_release, std::memory_order_relaxed))
+	{
+		delete text;
+	}
+}
+
+inline sav::DecimalSharedDigits::Digits& sav::DecimalSharedDigits::Mutable()
+{
+	Detach();
+	return m_block->m_digits;
+}
+
+inline std::uint8_t& sav::DecimalSharedDigits::operator[](std::size_t _index)
+{
+	return Mutable()[_index];
+}
+
+inline std::uint8_t* sav::DecimalSharedDigits::data()
+{
+	return Mutable().data();
+}
+
+inline sav::DecimalSharedDigits::iterator sav::DecimalSharedDigits::begin()
+{
+	return Mutable().begin();
+}
+
+inline sav::DecimalSharedDigits::iterator sav::DecimalSharedDigits::end()
+{
+	return Mutable().end();
+}
+
+inline std::uint8_t& sav::DecimalSharedDigits::back()
+{
+	return Mutable().back();
+}
+
+inline void sav::DecimalSharedDigits::push_back(std::uint8_t _digit)
+{
+	Mutable().push_back(_digit);
+}
+
+inline void sav::DecimalSharedDigits::pop_back()
+{
+	Mutable().pop_back();
+}
+
+inline void sav::DecimalSharedDigits::resize(std::size_t _size)
+{
+	Mutable().resize(_size);
+}
+
+inline void sav::DecimalSharedDigits::reserve(std::size_t _capacity)
+{
+	Mutable().reserve(_capacity);
+}
+
+template<typename... Arguments>
+inline sav::DecimalSharedDigits::iterator sav::DecimalSharedDigits::insert(const_iterator _position, Arguments&&... _arguments)
+{
+	// _position may point into a shared buffer, keep its offset across the detach.
+	auto offset = _position - static_cast<const Digits&>(*this).begin();
+	Digits& digits = Mutable();
+
+	return digits.insert(digits.begin() + offset, std::forward<Arguments>(_arguments)...);
+}
+
+inline void sav::DecimalSharedDigits::clear()
+{
+	Discard();
+	m_block->m_digits.clear();
+}
+
+template<typename... Arguments>
+inline void sav::DecimalSharedDigits::assign(Arguments&&... _arguments)
+{
+	Discard();
+	m_block->m_digits.assign(std::forward<Arguments>(_arguments)...);
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALSHAREDDIGITS_H
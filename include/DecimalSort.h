@@ -0,0 +1,50 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALSORT_H
+#define DECIMAL_VLN_BCD_DECIMALSORT_H
+
+#include "Decimal.h"
+
+#include <vector>
+
+namespace sav
+{
+	/**
+	 * RadixSort - sort values in ascending order without comparing them.
+	 * Values are bucketed by limb count first (a normalized value with more limbs is larger), then ordered
+	 * from the most significant limb down, each limb by an LSD byte radix; a limb is only looked at
+	 * for values whose higher limbs are all equal. Bytes equal across a range are skipped,
+	 * so e.g. amounts below 2^40 take five passes. Order of equal values is kept.
+	 * @param _values
+	 */
+	void RadixSort(std::vector<Decimal>& _values);
+
+	/**
+	 * Dedupe - remove repeated values keeping the first occurrence of each, in their original order.
+	 * Uses Decimal::Hash, values are compared only on equal hashes.
+	 * @param _values
+	 */
+	void Dedupe(std::vector<Decimal>& _values);
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALSORT_H
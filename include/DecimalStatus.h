@@ -33,7 +33,9 @@ namespace sav
 	{
 		Ok,
 		Error_DividedByZero,
-		Error_Underflow
+		Error_Underflow,
+		Error_InvalidArgument,
+		Error_IO
 	};
 }
 
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALSTREAMPARSER_H
+#define DECIMAL_VLN_BCD_DECIMALSTREAMPARSER_H
+
+#include "Decimal.h"
+
+#include <istream>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * @class DecimalStreamParser
+	 * Streaming parser of delimited base10 text (CSV fields, one value per line, or a mix of both).
+	 * Fields are split in place in a fixed-size chunk buffer and converted without any intermediate std::string.
+	 * A field spanning two chunks is moved to the front of the buffer before the next read, so memory stays
+	 * bounded by two chunks plus the longest field.
+	 * Fields are separated by the delimiter or a line break; spaces, tabs and '\r' around a value are ignored,
+	 * empty fields (blank lines, trailing delimiters) are skipped.
+	 */
+	class DecimalStreamParser
+	{
+		public:
+			enum : std::size_t
+			{
+				kDefaultChunkSize = 64 * 1024
+			};
+
+			/**
+			 * Constructor for a stream, read in chunks.
+			 * @param _input must outlive the parser
+			 * @param _delimiter field delimiter in addition to line breaks
+			 * @param _chunkSize bytes per read
+			 */
+			explicit DecimalStreamParser(std::istream& _input, char _delimiter = ',', std::size_t _chunkSize = kDefaultChunkSize);
+
+			/**
+			 * Constructor for a byte range already in memory (e.g. a mapped file), parsed without copying.
+			 * @param _data must outlive the parser
+			 * @param _size
+			 * @param _delimiter
+			 */
+			DecimalStreamParser(const char* _data, std::size_t _size, char _delimiter = ',');
+
+			/**
+			 * Next - parse the next field.
+			 * @param _value receives the value, its storage is reused
+			 * @return true if a value was parsed, false at the end of input or on error (@see Status)
+			 */
+			bool Next(Decimal& _value);
+
+			/**
+			 * Fill - append up to _count values to a batch.
+			 * @return count of values appended (less than _count only at the end of input or on error)
+			 */
+			std::size_t Fill(std::vector<Decimal>& _batch, std::size_t _count);
+
+			/**
+			 * Status - Ok, Error_InvalidArgument if a field is not a base10 number
+			 * (Fields() is then the index of that field), Error_IO if the stream failed.
+			 */
+			DecimalStatus Status() const noexcept;
+
+			// Returns false once an error occurred, true otherwise
+			explicit operator bool() const noexcept;
+
+			// Count of values parsed so far.
+			std::uint64_t Fields() const noexcept;
+
+		protected:
+			std::istream* m_input = nullptr;
+
+			std::vector<char> m_buffer;
+
+			std::size_t m_chunkSize = 0;
+
+			const char* m_cursor = nullptr;
+
+			const char* m_end = nullptr;
+
+			char m_delimiter;
+
+			bool m_exhausted = false;
+
+			std::uint64_t m_fields = 0;
+
+			DecimalStatus m_status = DecimalStatus::Ok;
+
+			// Move the unconsumed tail to the front of the buffer and read the next chunk behind it.
+			void Refill();
+
+			/**
+			 * Convert - base10 characters to a Decimal.
+			 * @return false if a character is not a digit
+			 */
+			static bool Convert(const char* _first, const char* _last, Decimal& _value);
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALSTREAMPARSER_H
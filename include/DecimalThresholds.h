@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALTHRESHOLDS_H
+#define DECIMAL_VLN_BCD_DECIMALTHRESHOLDS_H
+
+#include "DecimalStatus.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace sav
+{
+	/**
+	 * @class DecimalThresholds
+	 * Operand sizes (in 64-bit limbs) from which the library switches to the subquadratic algorithms.
+	 *
+	 * The defaults are compiled in and can be replaced by a header generated by Decimal_VLN_BCD_tune
+	 * (CMake cache variable Decimal_VLN_BCD_THRESHOLDS_HEADER). On first use, the file named by the
+	 * DECIMAL_VLN_BCD_THRESHOLDS environment variable, if set, overrides them at runtime.
+	 */
+	class DecimalThresholds
+	{
+		public:
+			enum : std::size_t
+			{
+				// Smallest accepted values: the recursive algorithms need a few limbs per half.
+				kMinKaratsuba = 4,
+				kMinBurnikelZiegler = 4,
+				kMinBase10 = 2
+			};
+
+			// Multiplication and squaring: Karatsuba from this size of the shorter operand.
+			std::size_t Karatsuba = 0;
+
+			// Division: Burnikel-Ziegler once both the divisor and the quotient reach this size.
+			std::size_t BurnikelZiegler = 0;
+
+			// Base10 conversions: divide and conquer above this size.
+			std::size_t Base10 = 0;
+
+			// Compiled-in values.
+			static DecimalThresholds Defaults();
+
+			// Values in use.
+			static DecimalThresholds Current();
+
+			// Replace the values in use, Error_InvalidArgument if one is below its minimum. Thread-safe.
+			static DecimalStatus Apply(const DecimalThresholds& _thresholds);
+
+			/**
+			 * Parse - read "name = value" lines (karatsuba, burnikel_ziegler, base10); '#' starts a comment.
+			 * Missing names keep their value in _thresholds.
+			 */
+			static DecimalStatus Parse(std::string_view _config, DecimalThresholds& _thresholds);
+
+			// Parse a file, Error_IO if it cannot be read.
+			static DecimalStatus Load(const std::string& _path, DecimalThresholds& _thresholds);
+
+			// Config file text, as read by Parse.
+			std::string ToConfig() const;
+
+			// Header text with the compile-time defaults, for Decimal_VLN_BCD_THRESHOLDS_HEADER.
+			std::string ToHeader() const;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALTHRESHOLDS_H
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALVIEW_H
+#define DECIMAL_VLN_BCD_DECIMALVIEW_H
+
+#include "Decimal.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	class DecimalIntegerDivisionResult;
+
+	/**
+	 * @class DecimalView
+	 * Read-only, non-owning view on little-endian base256 digits in a foreign buffer
+	 * (e.g. a serialized Decimal in a message or a cache entry).
+	 * Comparisons and arithmetic run directly on the viewed digits, nothing is copied into a Decimal
+	 * unless ToDecimal() is called. The buffer must outlive the view.
+	 */
+	class DecimalView
+	{
+		public:
+			// Constructor for a view on zero.
+			DecimalView() noexcept;
+
+			/**
+			 * Constructor for a view on raw little-endian base256 digits.
+			 * Most significant zeros are skipped, least significant zero limbs (8 digits) become implicit.
+			 */
+			DecimalView(const std::uint8_t* _digits, std::size_t _count) noexcept;
+
+			// Constructor for a view on digits of a Decimal (implicit, so that views and Decimals compare directly).
+			DecimalView(const Decimal& _decimal) noexcept;
+
+			/**
+			 * Parse - view on a value encoded by Decimal::Serialize.
+			 * @param _data
+			 * @param _size bytes available
+			 * @param _view receives the view on success
+			 * @return count of bytes consumed, 0 if the data is truncated or malformed
+			 */
+			static std::size_t Parse(const std::uint8_t* _data, std::size_t _size, DecimalView& _view) noexcept;
+
+			/**
+			 * Serialize - append the compact binary encoding of the viewed value to the buffer.
+			 * @see Decimal::Serialize for the format
+			 */
+			void Serialize(std::vector<std::uint8_t>& _buffer) const;
+
+			// Size of the Serialize encoding in bytes.
+			std::size_t SerializedSize() const noexcept;
+
+			// Copy the viewed value into an owning Decimal.
+			Decimal ToDecimal() const;
+
+			// Viewed digits, above the implicit zero limbs.
+			const std::uint8_t* Digits() const noexcept;
+
+			// Count of viewed digits (0 for zero).
+			std::size_t Size() const noexcept;
+
+			// Count of implicit zero 64-bit limbs below the viewed digits: the value is Digits() * 2^(64 * ZeroLimbs()).
+			std::size_t ZeroLimbs() const noexcept;
+
+			bool EqualsZero() const noexcept;
+
+			// -1, 0, 1
+			int Compare(const DecimalView& _rhs) const noexcept;
+
+			// Comparison operators
+			bool operator==(const DecimalView& _rhs) const noexcept;
+			bool operator!=(const DecimalView& _rhs) const noexcept;
+
+			bool operator<(const DecimalView& _rhs) const noexcept;
+			bool operator>(const DecimalView& _rhs) const noexcept;
+
+			bool operator<=(const DecimalView& _rhs) const noexcept;
+			bool operator>=(const DecimalView& _rhs) const noexcept;
+
+			// Arithmetic operators, same semantics as the Decimal ones.
+			Decimal operator+(const DecimalView& _rhs) const;
+			Decimal operator-(const DecimalView& _rhs) const;
+			Decimal operator*(const DecimalView& _rhs) const;
+			DecimalIntegerDivisionResult operator/(const DecimalView& _rhs) const;
+
+		protected:
+			const std::uint8_t* m_digits;
+
+			std::size_t m_size;
+
+			std::size_t m_zeroLimbs;
+	};
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALVIEW_H
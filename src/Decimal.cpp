@@ -23,279 +23,223 @@
 #include "Decimal.h"
 
 #include "DecimalIntegerDivisionResult.h"
+#include "DecimalExtendedGcdResult.h"
+#include "DecimalKernels.h"
+#include "DecimalView.h"
+#include "DecimalCharConv.h"
+#include "DecimalInstrumentation.h"
+#include "DecimalInline.h"
 
 #include <numeric>
 #include <algorithm>
 
-sav::Decimal::Decimal(unsigned int _initial)
+namespace
 {
-	for(;;)
+	// Little-endian base256 digits of a native unsigned value, without leading zeros (zero has no digits).
+	template<typename Unsigned>
+	std::vector<std::uint8_t> NativeDigits(Unsigned _value)
 	{
-		m_digits.push_back(_initial % kBase256);
-		_initial /= kBase256;
+		std::vector<std::uint8_t> digits;
+		digits.reserve(sizeof(Unsigned));
 
-		if(_initial == 0)
+		for(; _value != 0; _value >>= 8)
 		{
-			break;
+			digits.push_back(static_cast<std::uint8_t>(_value));
 		}
-	}
-}
-
-sav::Decimal::Decimal()
-{
-	m_digits.push_back(0x00);
-}
-
-sav::Decimal::Decimal(const std::string& _fromString)
-{
-	SetFromString(_fromString);
-}
 
-const sav::Decimal sav::Decimal::kDecimalWhichEqualUnsignedIntMax = sav::Decimal{
-	std::numeric_limits<unsigned int>::max()
-};
-
-const sav::Decimal sav::Decimal::kDecimalWhichEqualBase10 = sav::Decimal{
-	sav::Decimal::kBase10
-};
-
-std::optional<unsigned int> sav::Decimal::ToUInt() const
-{
-	if( (*this) > kDecimalWhichEqualUnsignedIntMax)
-	{
-		return std::nullopt;
+		return digits;
 	}
 
-	unsigned int result = 0;
-
-	// m_digits == 0x02 0x00 0x01 // 65538
-	// result = 0x02 * 256^0 + 0x00 * 256^1 + 0x01 * 256^2 == 2 + 0 + 65536 == 65538
-	for(int i = 0; i < m_digits.size(); i++)
+	// Normalized digits with _zeroLimbs implicit zero limbs below as a native unsigned value, std::nullopt if it does not fit.
+	template<typename Unsigned>
+	std::optional<Unsigned> NativeValue(const std::vector<std::uint8_t>& _digits, std::size_t _zeroLimbs)
 	{
-		result += m_digits[i] * UnsafeIntegerPower(kBase256, i);
-	}
+		// The most significant digit is not zero: the value fits exactly when its digits do.
+		if(_zeroLimbs > sizeof(Unsigned) / sizeof(std::uint64_t) ||
+			_digits.size() + _zeroLimbs * sizeof(std::uint64_t) > sizeof(Unsigned))
+		{
+			return std::nullopt;
+		}
 
-	return std::optional<unsigned int>{result};
-}
+		Unsigned result = 0;
+		for(auto digit = _digits.rbegin(); digit != _digits.rend(); ++digit)
+		{
+			result = static_cast<Unsigned>(result << 8) | *digit;
+		}
 
-bool sav::Decimal::operator==(const sav::Decimal& _rhs) const
-{
-	return this->m_digits == _rhs.m_digits;
-}
+		for(std::size_t i = 0; i < _zeroLimbs * sizeof(std::uint64_t); i++)
+		{
+			result <<= 8;
+		}
 
-bool sav::Decimal::operator!=(const sav::Decimal& _rhs) const
-{
-	return !((*this) == _rhs);
+		return result;
+	}
 }
 
-bool sav::Decimal::operator<(const sav::Decimal& _rhs) const
+namespace
 {
-	if(this->m_digits.size() > _rhs.m_digits.size())
-	{
-		return false;
-	}
-
-	for(int i = this->m_digits.size() - 1; i >= 0; i--)
+	/**
+	 * RoundUp - whether a truncated quotient is rounded up.
+	 * The fraction remainder / divisor is compared against one half as 2 * remainder against the divisor.
+	 * Example:
+	 * 10000 / 6 = 1666, remainder 4 : 8 > 6, above one half (1666.666... -> 1667)
+	 * @param _half returns the sign of 2 * remainder - divisor, called only by the half modes
+	 */
+	template<typename HalfComparison>
+	bool RoundUp(sav::DecimalRoundingMode _mode, bool _remainder, bool _oddQuotient, HalfComparison&& _half)
 	{
-		if(i > _rhs.m_digits.size() - 1)
+		if(!_remainder)
 		{
-			continue;
+			return false;
 		}
 
-		if(this->m_digits[i] == _rhs.m_digits[i])
+		switch(_mode)
 		{
-			continue;
+			case sav::DecimalRoundingMode::HalfUp:
+				return _half() >= 0;
+			case sav::DecimalRoundingMode::HalfEven:
+			{
+				const int half = _half();
+				return half > 0 || (half == 0 && _oddQuotient);
+			}
+			case sav::DecimalRoundingMode::HalfDown:
+				return _half() > 0;
+			case sav::DecimalRoundingMode::Ceiling:
+				return true;
+			case sav::DecimalRoundingMode::Floor:
+			case sav::DecimalRoundingMode::Truncate:
+				break;
 		}
 
-		return this->m_digits[i] < _rhs.m_digits[i];
+		return false;
 	}
-
-	// Unreachable
-	return false;
 }
 
-bool sav::Decimal::operator>(const sav::Decimal& _rhs) const
+sav::Decimal::Decimal()
 {
-	return !((*this) == _rhs) && !((*this) < _rhs);
-}
 
-bool sav::Decimal::operator<=(const sav::Decimal& _rhs) const
-{
-	return ((*this) < _rhs) || ((*this) == _rhs);
 }
 
-bool sav::Decimal::operator>=(const sav::Decimal& _rhs) const
+sav::Decimal::Decimal(std::string_view _fromString)
 {
-	return (!((*this) < _rhs)) || ((*this) == _rhs);
+	SetFromString(_fromString);
 }
 
-unsigned int sav::Decimal::UnsafeIntegerPower(unsigned int _base, unsigned int _index)
+#ifdef __SIZEOF_INT128__
+sav::Decimal sav::Decimal::FromUInt128(unsigned __int128 _value)
 {
-	if(_index == 0)
-	{
-		return 1;
-	}
-
-	if(_base == 0)
-	{
-		throw;
-	}
-
-	unsigned int result = 0;
+	instrumentation::Scope scope{DecimalOperation::Construct, sizeof(_value)};
 
-	unsigned int accum = 1;
-	for(unsigned int i = 0; i < _index; i++)
-	{
-		accum *= _base;
-	}
-
-	result += accum;
+	Decimal result;
+	result.m_digits = NativeDigits(_value);
+	result.Normalize();
 
 	return result;
 }
+#endif
 
-std::string sav::Decimal::ToString() const
+std::optional<unsigned int> sav::Decimal::ToUInt() const
 {
-	if(this->EqualsZero())
-	{
-		return "0";
-	}
-
-	auto intermediateResult = std::optional<DecimalIntegerDivisionResult>();
-	intermediateResult->Quotient = (*this);
-	std::string result;
-
-	do
-	{
-		intermediateResult = intermediateResult->Quotient / kDecimalWhichEqualBase10;
-		result += std::to_string(intermediateResult->Remainder.ToUInt().value());
-	}while(!intermediateResult->Quotient.EqualsZero());
+	return NativeValue<unsigned int>(m_digits, m_zeroLimbs);
+}
 
-	std::reverse(result.begin(), result.end());
+std::optional<std::uint64_t> sav::Decimal::ToUInt64() const
+{
+	return NativeValue<std::uint64_t>(m_digits, m_zeroLimbs);
+}
 
-	return result;
+std::uint64_t sav::Decimal::ToUInt64Saturated() const
+{
+	return ToUInt64().value_or(std::numeric_limits<std::uint64_t>::max());
 }
 
-sav::Decimal::operator bool() const
+#ifdef __SIZEOF_INT128__
+std::optional<unsigned __int128> sav::Decimal::ToUInt128() const
 {
-	return m_status == DecimalStatus::Ok;
+	return NativeValue<unsigned __int128>(m_digits, m_zeroLimbs);
 }
 
-sav::Decimal sav::Decimal::operator+(const sav::Decimal& _rhs) const
+unsigned __int128 sav::Decimal::ToUInt128Saturated() const
 {
-	Decimal result;
-	result.m_digits.clear();
+	return ToUInt128().value_or(~static_cast<unsigned __int128>(0));
+}
+#endif
 
-	std::uint8_t carry = 0;
-	std::uint8_t accumulator = 0;
+std::size_t sav::Decimal::Hash() const
+{
+	// wyhash secrets
+	constexpr std::uint64_t kSecret[] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
 
-	for(int i = 0; i < this->m_digits.size() || i < _rhs.m_digits.size(); i++)
+	// 64x64 -> 128-bit product folded to 64 bits.
+	auto mix = [](std::uint64_t _lhs, std::uint64_t _rhs)
 	{
-		// reset accumulator from previous addition
-		accumulator = 0;
+		kernels::Limb high = 0;
+		const kernels::Limb low = kernels::MulWide(_lhs, _rhs, high);
+		return low ^ high;
+	};
 
-		// add and reset carry from previous addition
-		if( (accumulator + carry) < accumulator)
-		{
-			accumulator += carry;
-			// cock carry again in case of overflow
-			carry = 1;
-		}
-		else
-		{
-			accumulator += carry;
-			carry = 0;
-		}
+	// Equal values are stored the same way: the implicit zero limbs and the digits identify the value.
+	std::uint64_t hash = mix(m_zeroLimbs ^ kSecret[0], m_digits.size() ^ kSecret[1]);
 
-		if(i < this->m_digits.size())
-		{
-			// overflow checking and set carry if needed
-			if( (accumulator + static_cast<int>(this->m_digits[i])) > std::numeric_limits<std::uint8_t>::max())
-			{
-				carry = 1;
-			}
-
-			// perform actual addition
-			accumulator += this->m_digits[i];
-		}
+	const std::uint8_t* digits = m_digits.data();
+	const std::size_t size = m_digits.size();
 
-		if(i < _rhs.m_digits.size())
+	for(std::size_t i = 0; i < size; i += sizeof(std::uint64_t))
+	{
+		std::uint64_t limb = 0;
+		for(std::size_t j = std::min(size, i + sizeof(std::uint64_t)); j-- > i; )
 		{
-			// overflow checking and set carry if needed
-			if( (accumulator + static_cast<int>(_rhs.m_digits[i])) > std::numeric_limits<std::uint8_t>::max())
-			{
-				carry = 1;
-			}
-
-			// perform actual addition
-			accumulator += _rhs.m_digits[i];
+			limb = (limb << 8) | digits[j];
 		}
 
-		result.m_digits.push_back(accumulator);
+		hash = mix(limb ^ kSecret[2], hash ^ kSecret[1]);
 	}
 
-	if(carry)
-	{
-		result.m_digits.push_back(0x01);
-	}
-
-	return result;
+	return static_cast<std::size_t>(mix(hash ^ kSecret[3], size ^ kSecret[0]));
 }
 
-sav::Decimal sav::Decimal::operator-(const sav::Decimal& _rhs) const
+int sav::Decimal::CompareLimbs(const sav::Decimal& _rhs) const
 {
-	Decimal result;
+	return DecimalView{*this}.Compare(DecimalView{_rhs});
+}
 
-	if( (*this) < _rhs)
-	{
-		result.m_status = DecimalStatus::Error_Underflow;
-		return result;
-	}
+std::string sav::Decimal::ToString() const
+{
+	instrumentation::Scope scope{DecimalOperation::ToString, DigitCount()};
 
-	if( (*this) == _rhs)
-	{
-		return result;
-	}
+	std::string result(to_chars_max_length(*this), '0');
 
-	// Prepare for the actual arbitraty-based subtraction.
-	result = (*this);
+	auto conversion = to_chars(result.data(), result.data() + result.size(), *this);
+	result.resize(conversion.ptr - result.data());
 
-	std::uint8_t carry = 0;
+	return result;
+}
 
-	for(int i = 0; i < result.m_digits.size(); i++)
+std::string sav::Decimal::ToCachedString() const
+{
+	if(const std::string* cached = m_digits.CachedText(m_zeroLimbs))
 	{
-		// subtract and reset carry from previous subtraction
-		if(result.m_digits[i] < carry)
-		{
-			result.m_digits[i] -= carry;
-			// cock carry again in case of underflow
-			carry = 1;
-		}
-		else
-		{
-			result.m_digits[i] -= carry;
-			carry = 0;
-		}
-
-		if(i < _rhs.m_digits.size())
-		{
-			// underflow checking and set carry if needed
-			if(result.m_digits[i] < _rhs.m_digits[i])
-			{
-				carry = 1;
-			}
-
-			// perform actual subtraction
-			result.m_digits[i] -= _rhs.m_digits[i];
-		}
+		return *cached;
 	}
 
-	result.Normalize();
+	std::string result = ToString();
+	m_digits.CacheText(m_zeroLimbs, result);
 
 	return result;
 }
 
-sav::Decimal sav::Decimal::operator*(const sav::Decimal& _rhs) const
+sav::Decimal sav::Decimal::AddLimbs(const sav::Decimal& _rhs) const
+{
+	// Only the digits above the common implicit zero limbs are added.
+	return DecimalView{*this} + DecimalView{_rhs};
+}
+
+sav::Decimal sav::Decimal::SubtractLimbs(const sav::Decimal& _rhs) const
+{
+	return DecimalView{*this} - DecimalView{_rhs};
+}
+
+sav::Decimal sav::Decimal::MultiplyLimbs(const sav::Decimal& _rhs) const
 {
 	Decimal result;
 
@@ -309,213 +253,211 @@ sav::Decimal sav::Decimal::operator*(const sav::Decimal& _rhs) const
 
 	// if one of multipliers equal to 1, return the other one
 	//
-	if(this->m_digits.size() == 1 && this->m_digits[0] == 0x01)
+	if(this->m_zeroLimbs == 0 && this->m_digits.size() == 1 && this->m_digits[0] == 0x01)
 	{
 		return _rhs;
 	}
 	//
-	if(_rhs.m_digits.size() == 1 && _rhs.m_digits[0] == 0x01)
+	if(_rhs.m_zeroLimbs == 0 && _rhs.m_digits.size() == 1 && _rhs.m_digits[0] == 0x01)
 	{
 		return (*this);
 	}
 
-	// Perform an actual multiplication
-	std::uint8_t carry = 0;
-	for(int currentRhsDigit = 0; currentRhsDigit < _rhs.m_digits.size(); currentRhsDigit++)
-	{
-		Decimal intermediateSum;
-		intermediateSum.m_digits.clear();
-
-		// 1234 * 567 =
-		// 1234 * 7 * 10^0 + 1234 * 6 * 10^1 + 1234 * 5 * 10^2 =
-		// __8638 + <- intermediate sum 0 (0th digit of the second multiplier: 0 digits to complete) : --
-		// _74040 + <- intermediate sum 1 (1th digit of the second multiplier: 1 digits to complete) : 0
-		// 123900   <- intermediate sum 2 (2th digit of the second multiplier: 2 digits to complete) : 00
-		//
-		// index of 10 is a count of digits to complete for each next intermediate sum
-		// (notice it's actually base256, not base10)
-		for(int i = 0; i < currentRhsDigit; i++)
-		{
-			intermediateSum.m_digits.push_back(0x00);
-		}
-
-		for(int currentThisDigit = 0; currentThisDigit < this->m_digits.size(); currentThisDigit++)
-		{
-			// 1234 *
-			//	567
-			//	Step 1: 1234 * 7 ,
-			//		Step 1.1 : 4 * 7, reg = 4 * 7 = 28, current digit = 8, carry = 2
-			//		Step 1.2 : 3 * 7, reg = 3 * 7 = 21, current digit = carry (which is still 2) + 1 = 3, new carry = 2
-			//		...
-			std::uint16_t reg =  _rhs.m_digits[currentRhsDigit] * this->m_digits[currentThisDigit];
-			intermediateSum.m_digits.push_back(carry + static_cast<std::uint8_t>(reg & static_cast<std::uint8_t>(0xFF)));
-			carry = (reg & static_cast<std::uint16_t>(0xFF'00)) >> (sizeof(std::uint8_t) * CHAR_BIT * 1);
-		}
-
-		// If carry occured in the most significant digit
-		if(carry != 0x00)
-		{
-			intermediateSum.m_digits.push_back(carry);
-		}
-
-		// Accumulate intermediate sum
-		result += intermediateSum;
-	}
+	// Perform an actual multiplication on 64-bit limbs (schoolbook or Karatsuba, depending on the size),
+	// the implicit zero limbs of both sides are only added up.
+	result.AssignLimbs(kernels::Multiply(kernels::ToLimbs(this->m_digits), kernels::ToLimbs(_rhs.m_digits)),
+		this->m_zeroLimbs + _rhs.m_zeroLimbs);
 
 	return result;
 }
 
 sav::DecimalIntegerDivisionResult sav::Decimal::operator/(const sav::Decimal& _rhs) const
 {
-	DecimalIntegerDivisionResult result;
+	instrumentation::Scope scope{DecimalOperation::Divide, std::max(DigitCount(), _rhs.DigitCount())};
 
-	if(_rhs.m_digits.size() == 1 && _rhs.m_digits[0] == 0x00)
+	if(SingleLimb() && _rhs.SingleLimb() && !_rhs.EqualsZero())
 	{
-		result.m_divisionStatus = DecimalStatus::Error_DividedByZero;
+		DecimalIntegerDivisionResult result;
+		result.Quotient = Decimal{SingleLimbValue() / _rhs.SingleLimbValue()};
+		result.Remainder = Decimal{SingleLimbValue() % _rhs.SingleLimbValue()};
+
 		return result;
 	}
 
-	if((*this) < _rhs)
+	// Knuth's long division on 64-bit limbs, Burnikel-Ziegler recursive division for large operands
+	return DecimalView{*this} / DecimalView{_rhs};
+}
+
+sav::Decimal sav::Decimal::Square() const
+{
+	instrumentation::Scope scope{DecimalOperation::Square, DigitCount()};
+
+	Decimal result;
+
+	if(!(*this))
 	{
-		result.Remainder = (*this);
+		result.m_status = m_status;
 		return result;
 	}
 
-	Decimal mutableThis = (*this);
-	int currentFrameEnd = mutableThis.m_digits.size();
-	int currentFrameBegin = currentFrameEnd - _rhs.m_digits.size();
-	int loanedDigits = 0;
-	Decimal currentFrame;
+	result.AssignLimbs(kernels::Square(kernels::ToLimbs(this->m_digits)), 2 * m_zeroLimbs);
 
-	bool first = true;
-	for(;;)
-	{
-		if(currentFrameBegin - loanedDigits < 0)
-		{
-			if(loanedDigits != 0)
-			{
-				result.Quotient.AmplifyInBase256(loanedDigits - 1);
-				result.Quotient.Normalize();
+	return result;
+}
 
-				currentFrameBegin -= loanedDigits;
-				loanedDigits = 0;
-			}
+sav::Decimal sav::Decimal::Pow(std::uint64_t _exponent) const
+{
+	instrumentation::Scope scope{DecimalOperation::Pow, DigitCount()};
 
-			break;
-		}
+	Decimal result;
 
-		currentFrame.m_digits =
-			std::vector<std::uint8_t>{
-				mutableThis.m_digits.begin() + currentFrameBegin - loanedDigits,
-				mutableThis.m_digits.begin() + currentFrameEnd
-			};
+	if(!(*this))
+	{
+		result.m_status = m_status;
+		return result;
+	}
 
-		currentFrame.Normalize();
+	result.AssignLimbs(kernels::Power(kernels::ToLimbs(this->m_digits), _exponent), m_zeroLimbs * _exponent);
 
-		if(currentFrame < _rhs)
-		{
-			loanedDigits++;
-			continue;
-		}
+	return result;
+}
 
-		//
+sav::Decimal sav::Decimal::Pow10(std::uint64_t _exponent)
+{
+	// 10^n = 5^n * 2^n, and the multiplication by 2^n is just a shift
+	auto power = kernels::Power(kernels::Limbs{5}, _exponent);
 
-		if(loanedDigits != 0)
-		{
-			result.Quotient.AmplifyInBase256(loanedDigits);
-			result.Quotient.Normalize();
+	const std::size_t shiftLimbs = _exponent / kernels::kLimbBits;
+	const unsigned int shiftBits = _exponent % kernels::kLimbBits;
 
-			currentFrameBegin -= loanedDigits;
-			loanedDigits = 0;
-		}
+	kernels::Limbs shifted(shiftLimbs + power.size() + 1, 0);
+	shifted.back() = kernels::LShift(shifted.data() + shiftLimbs, power.data(), power.size(), shiftBits);
 
-		while(currentFrame >= _rhs)
-		{
-			currentFrame -= _rhs;
-			result.Quotient++;
-		}
+	Decimal result;
+	result.AssignLimbs(shifted);
 
-		for(int i = currentFrameBegin; i < currentFrameEnd; i++)
-		{
-			if(i - currentFrameBegin >= currentFrame.m_digits.size())
-			{
-				mutableThis.m_digits[i] = 0x00;
-			}
-			else
-			{
-				mutableThis.m_digits[i] = currentFrame.m_digits[i - currentFrameBegin];
-			}
-		}
+	return result;
+}
 
-		if(currentFrame.EqualsZero())
-		{
-			currentFrameEnd = currentFrameBegin;
-			loanedDigits += _rhs.m_digits.size();
-		}
+sav::Decimal sav::Decimal::Pow2(std::uint64_t _exponent)
+{
+	Decimal result;
 
-		first = false;
-	}
+	// 2^n = (n / 64 zero limbs) 0x00 ... 0x00 (n % 64 / 8 digits) 2^(n % 8)
+	const std::uint64_t bits = _exponent % kernels::kLimbBits;
 
-	result.Remainder = currentFrame;
-	result.Remainder.Normalize();
+	result.m_digits.assign(bits / std::numeric_limits<std::uint8_t>::digits, 0x00);
+	result.m_digits.push_back(static_cast<std::uint8_t>(1u << (bits % std::numeric_limits<std::uint8_t>::digits)));
+	result.m_zeroLimbs = _exponent / kernels::kLimbBits;
 
 	return result;
 }
 
-sav::Decimal& sav::Decimal::operator+=(const sav::Decimal& _rhs)
+void sav::Decimal::Serialize(std::vector<std::uint8_t>& _buffer) const
 {
-	(*this) = (*this) + _rhs;
+	DecimalView{*this}.Serialize(_buffer);
+}
 
-	return (*this);
+std::size_t sav::Decimal::SerializedSize() const
+{
+	return DecimalView{*this}.SerializedSize();
 }
 
-sav::Decimal& sav::Decimal::operator-=(const sav::Decimal& _rhs)
+sav::DecimalStatus sav::Decimal::Deserialize(const std::uint8_t* _data, std::size_t _size)
 {
-	(*this) = (*this) - _rhs;
+	DecimalView view;
 
-	return (*this);
+	if(DecimalView::Parse(_data, _size, view) == 0)
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	(*this) = view.ToDecimal();
+
+	return DecimalStatus::Ok;
 }
 
-sav::Decimal& sav::Decimal::operator*=(const sav::Decimal& _rhs)
+void sav::Decimal::Normalize()
 {
-	(*this) = (*this) * _rhs;
+	// Read through the const view, an already normalized shared buffer is left shared.
+	const std::vector<std::uint8_t>& digits = m_digits;
 
-	return (*this);
+	std::size_t size = digits.size();
+	while(size > 1 && digits[size - 1] == 0x00)
+	{
+		size--;
+	}
+
+	// Whole zero limbs below the most significant digit become implicit.
+	std::size_t zeros = 0;
+	while(zeros + sizeof(std::uint64_t) < size &&
+		std::all_of(digits.begin() + zeros, digits.begin() + zeros + sizeof(std::uint64_t), [](std::uint8_t _digit) { return _digit == 0x00; }))
+	{
+		zeros += sizeof(std::uint64_t);
+	}
+
+	if(size == 0 || (size == 1 && digits[0] == 0x00))
+	{
+		m_digits = DecimalSharedDigits{};
+		m_zeroLimbs = 0;
+	}
+	else if(zeros != 0)
+	{
+		m_digits = std::vector<std::uint8_t>(digits.begin() + zeros, digits.begin() + size);
+		m_zeroLimbs += zeros / sizeof(std::uint64_t);
+	}
+	else if(size != digits.size())
+	{
+		m_digits.resize(size);
+	}
 }
 
-void sav::Decimal::Normalize()
+std::vector<std::uint64_t> sav::Decimal::ToLimbs() const
+{
+	return kernels::ToLimbs(m_digits.data(), m_digits.size(), m_zeroLimbs);
+}
+
+void sav::Decimal::AssignLimbs(const std::vector<std::uint64_t>& _limbs, std::size_t _zeroLimbs)
 {
-	for(int i = m_digits.size() - 1; i >= 0; i--)
+	std::size_t low = 0;
+	while(low < _limbs.size() && _limbs[low] == 0)
 	{
-		if( m_digits[i] != 0x00 )
-		{
-			m_digits = std::vector<std::uint8_t>{m_digits.begin(), m_digits.begin() + i + 1};
-			return;
-		}
+		low++;
 	}
 
-	// If internal array was like 0x00 0x00 0x00 ... 0x00
-	m_digits.clear();
-	m_digits.push_back(0x00);
+	if(low == _limbs.size())
+	{
+		m_digits = DecimalSharedDigits{};
+		m_zeroLimbs = 0;
+		return;
+	}
+
+	m_digits = kernels::ToDigits(_limbs.data() + low, _limbs.size() - low);
+	m_zeroLimbs = _zeroLimbs + low;
 }
 
-bool sav::Decimal::EqualsZero() const
+void sav::Decimal::Expand()
 {
-	if(m_digits.size() == 1 && m_digits[0] == 0x00)
+	if(m_zeroLimbs == 0)
 	{
-		return true;
+		return;
 	}
 
-	return false;
+	m_digits.insert(m_digits.begin(), m_zeroLimbs * sizeof(std::uint64_t), std::uint8_t{0x00});
+	m_zeroLimbs = 0;
 }
 
 sav::Decimal& sav::Decimal::operator++(int)
 {
+	Expand();
+
 	for(int i = 0; i < m_digits.size(); i++)
 	{
 		if(m_digits[i] != std::numeric_limits<std::uint8_t>::max())
 		{
 			m_digits[i]++;
+			// a carry may have left whole zero limbs behind
+			Normalize();
 			return (*this);
 		}
 		else
@@ -527,17 +469,21 @@ sav::Decimal& sav::Decimal::operator++(int)
 	// 9999 -> 10000
 	std::fill(m_digits.begin(), m_digits.end(), 0x00);
 	m_digits.push_back(0x01);
+	Normalize();
 
 	return (*this);
 }
 
 sav::Decimal& sav::Decimal::operator--(int)
 {
+	Expand();
+
 	for(int i = 0; i < m_digits.size(); i++)
 	{
 		if(m_digits[i] != std::numeric_limits<std::uint8_t>::min())
 		{
 			m_digits[i]--;
+			Normalize();
 			return (*this);
 		}
 		else
@@ -552,88 +498,223 @@ sav::Decimal& sav::Decimal::operator--(int)
 
 sav::Decimal& sav::Decimal::AmplifyInBase256(int _digits)
 {
-	for(int i = 0; i < _digits; i++)
+	if(_digits <= 0 || EqualsZero())
+	{
+		return (*this);
+	}
+
+	// Whole limbs are implicit, only the rest is inserted (which may complete a zero limb).
+	const std::size_t rest = _digits % sizeof(std::uint64_t);
+	if(rest != 0)
 	{
-		m_digits.insert(m_digits.begin(), 0x00);
+		m_digits.insert(m_digits.begin(), rest, std::uint8_t{0x00});
 	}
+	m_zeroLimbs += _digits / sizeof(std::uint64_t);
+
+	Normalize();
 
 	return (*this);
 }
 
 sav::Decimal& sav::Decimal::AmplifyInBase10(int _digits)
 {
-	for(int i = 0; i < _digits; i++)
+	if(_digits > 0)
 	{
-		this->operator*=(kDecimalWhichEqualBase10);
+		this->operator*=(Pow10(_digits));
 	}
 
 	return (*this);
 }
 
-sav::DecimalStatus sav::Decimal::SetFromString(const std::string& _fromString)
+sav::DecimalStatus sav::Decimal::SetFromString(std::string_view _fromString)
 {
-	m_digits.clear();
-	m_digits.push_back(0x00);
+	// log256(10) ~ 10 / 24 base256 digits per character
+	instrumentation::Scope scope{DecimalOperation::SetFromString, _fromString.size() * 10 / 24};
+
+	m_digits.assign(1, 0x00);
+	m_zeroLimbs = 0;
+	m_status = DecimalStatus::Ok;
 
-	int currentParseIndexFromEnd = 0;
-	while(currentParseIndexFromEnd < _fromString.size())
+	if(_fromString.empty())
 	{
-		this->operator+=(
-			sav::Decimal{
-				static_cast<unsigned int>(
-					std::stoi(
-						std::string{
-							_fromString.rbegin() + currentParseIndexFromEnd,
-							_fromString.rbegin() + currentParseIndexFromEnd + 1
-						}
-					)
-				)
-			}.AmplifyInBase10(currentParseIndexFromEnd)
-		);
+		return m_status;
+	}
 
-		currentParseIndexFromEnd++;
+	auto conversion = from_chars(_fromString, *this);
+	if(conversion.ec != std::errc{} || conversion.ptr != _fromString.data() + _fromString.size())
+	{
+		m_digits.assign(1, 0x00);
+		m_zeroLimbs = 0;
+		m_status = DecimalStatus::Error_InvalidArgument;
 	}
 
-	return DecimalStatus::Ok;
+	return m_status;
+}
+
+sav::Decimal sav::Decimal::DivideAndRound(const sav::Decimal& _divisor, sav::DecimalRoundingMode _mode) const
+{
+	instrumentation::Scope scope{DecimalOperation::DivideAndRound, std::max(DigitCount(), _divisor.DigitCount())};
+
+	sav::Decimal result;
+
+	if(_divisor.EqualsZero())
+	{
+		result.m_status = DecimalStatus::Error_DividedByZero;
+		return result;
+	}
+
+	// Single-limb operands (e.g. money amounts) are divided natively.
+	if(SingleLimb() && _divisor.SingleLimb())
+	{
+		const std::uint64_t divisor = _divisor.SingleLimbValue();
+		std::uint64_t quotient = SingleLimbValue() / divisor;
+		const std::uint64_t remainder = SingleLimbValue() % divisor;
+
+		// 2 * remainder against the divisor without overflow: remainder against divisor - remainder.
+		auto half = [&]()
+		{
+			return remainder > divisor - remainder ? 1 : (remainder == divisor - remainder ? 0 : -1);
+		};
+
+		// The divisor is at least 2 when there is a remainder, the increment does not overflow.
+		if(RoundUp(_mode, remainder != 0, (quotient & 1) != 0, half))
+		{
+			quotient++;
+		}
+
+		return Decimal{quotient};
+	}
+
+	// The common implicit zero limbs scale the remainder and the divisor alike, the rounding does not change.
+	const std::size_t zeroLimbs = std::min(m_zeroLimbs, _divisor.m_zeroLimbs);
+	const auto dividend = kernels::ToLimbs(m_digits.data(), m_digits.size(), m_zeroLimbs - zeroLimbs);
+	const auto divisor = kernels::ToLimbs(_divisor.m_digits.data(), _divisor.m_digits.size(), _divisor.m_zeroLimbs - zeroLimbs);
+
+	kernels::Limbs quotient;
+	kernels::Limbs remainder;
+	kernels::DivRem(dividend, divisor, quotient, remainder);
+
+	auto half = [&]()
+	{
+		return kernels::CompareDoubled(remainder, divisor);
+	};
+
+	if(RoundUp(_mode, !remainder.empty(), !quotient.empty() && (quotient[0] & 1) != 0, half))
+	{
+		kernels::Increment(quotient);
+	}
+
+	result.AssignLimbs(quotient);
+	return result;
 }
 
 sav::Decimal sav::Decimal::DivideAndRoundInBase10(const sav::Decimal& _divisor) const
 {
+	return DivideAndRound(_divisor, DecimalRoundingMode::HalfUp);
+}
+
+sav::Decimal sav::Decimal::DivExact(const sav::Decimal& _divisor) const
+{
+	instrumentation::Scope scope{DecimalOperation::DivExact, std::max(DigitCount(), _divisor.DigitCount())};
+
 	sav::Decimal result;
 
-	auto divisionResult = (*this) / _divisor;
-	if(!divisionResult)
+	if(_divisor.EqualsZero())
 	{
-		// Seems to be division by zero, nothing to round.
-		result.m_status = divisionResult.m_divisionStatus;
+		result.m_status = DecimalStatus::Error_DividedByZero;
 		return result;
 	}
 
-	// Division occured without remainder, nothing to round.
-	if(divisionResult.Remainder.EqualsZero())
+	auto divisor = _divisor.ToLimbs();
+	auto quotient = kernels::DivExact(this->ToLimbs(), divisor);
+
+#ifndef NDEBUG
+	if(kernels::Compare(kernels::Multiply(quotient, divisor), this->ToLimbs()) != 0)
 	{
-		result = divisionResult.Quotient;
+		result.m_status = DecimalStatus::Error_InvalidArgument;
 		return result;
 	}
+#endif
 
-	/**
-	 * To properly round in base10 using 4/5 rule, determine the most significant digit in the rounded part.
-	 * Example:
-	 * 10000 / 6 = 1666.666...
-	 *                  ^ We need the first digit after .
-	 *                  (6 > 5) -> (1666.666... -> 1667)
-	 */
-	auto intermediate = divisionResult.Remainder / kDecimalWhichEqualBase10;
-	auto firstDigitToCompleteRounding = intermediate.Quotient.ToUInt();
-	if(!firstDigitToCompleteRounding)
+	result.AssignLimbs(quotient);
+	return result;
+}
+
+sav::Decimal sav::Decimal::Gcd(const sav::Decimal& _lhs, const sav::Decimal& _rhs)
+{
+	instrumentation::Scope scope{DecimalOperation::Gcd, std::max(_lhs.DigitCount(), _rhs.DigitCount())};
+
+	sav::Decimal result;
+
+	if(!_lhs || !_rhs)
+	{
+		result.m_status = !_lhs ? _lhs.m_status : _rhs.m_status;
+		return result;
+	}
+
+	result.AssignLimbs(kernels::Gcd(_lhs.ToLimbs(), _rhs.ToLimbs()));
+	return result;
+}
+
+sav::Decimal sav::Decimal::Lcm(const sav::Decimal& _lhs, const sav::Decimal& _rhs)
+{
+	if(_lhs.EqualsZero() || _rhs.EqualsZero())
+	{
+		sav::Decimal result;
+		result.m_status = !_lhs ? _lhs.m_status : _rhs.m_status;
+		return result;
+	}
+
+	auto gcd = Gcd(_lhs, _rhs);
+	if(!gcd)
+	{
+		return gcd;
+	}
+
+	return _lhs.DivExact(gcd) * _rhs;
+}
+
+sav::DecimalExtendedGcdResult sav::Decimal::ExtendedGcd(const sav::Decimal& _lhs, const sav::Decimal& _rhs)
+{
+	instrumentation::Scope scope{DecimalOperation::Gcd, std::max(_lhs.DigitCount(), _rhs.DigitCount())};
+
+	DecimalExtendedGcdResult result;
+
+	if(!_lhs || !_rhs)
 	{
-		throw;
+		result.m_status = !_lhs ? _lhs.m_status : _rhs.m_status;
+		return result;
 	}
-	if(firstDigitToCompleteRounding.value() >= 5)
+
+	auto lhs = _lhs.ToLimbs();
+	auto rhs = _rhs.ToLimbs();
+
+	kernels::Limbs lhsCoefficient;
+	auto gcd = kernels::ExtendedGcd(lhs, rhs, lhsCoefficient, result.CoefficientANegative);
+
+	// a * X - g == b * Y (X >= 0) or g + a * |X| == b * Y (X < 0)
+	kernels::Limbs rhsCoefficient;
+	if(!rhs.empty())
 	{
-		divisionResult.Quotient++;
+		auto product = kernels::Multiply(lhs, lhsCoefficient);
+		if(result.CoefficientANegative)
+		{
+			// X == 0 when b divides a: the product is then narrower than g.
+			product.resize(std::max(product.size(), gcd.size()) + 1, 0);
+			kernels::Add(product.data(), product.data(), product.size(), gcd.data(), gcd.size());
+		}
+		else
+		{
+			kernels::Sub(product.data(), product.data(), product.size(), gcd.data(), gcd.size());
+		}
+		kernels::Trim(product);
+
+		rhsCoefficient = kernels::DivExact(product, rhs);
 	}
 
-	result = divisionResult.Quotient;
+	result.Gcd.AssignLimbs(gcd);
+	result.CoefficientA.AssignLimbs(lhsCoefficient);
+	result.CoefficientB.AssignLimbs(rhsCoefficient);
+
 	return result;
 }
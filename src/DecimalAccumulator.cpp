@@ -0,0 +1,306 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalAccumulator.h"
+
+#include <algorithm>
+
+sav::DecimalAccumulator::DecimalAccumulator()
+{
+
+}
+
+sav::DecimalAccumulator::DecimalAccumulator(const sav::Decimal& _initial)
+{
+	Add(_initial);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::Add(const sav::Decimal& _addend)
+{
+	if(!_addend)
+	{
+		m_status = _addend.m_status;
+		return (*this);
+	}
+
+	ReserveHeadroom(std::numeric_limits<std::uint8_t>::max());
+	// implicit zero limbs of the addend just shift its columns
+	AddDigits(_addend.m_digits.data(), _addend.m_digits.size(), _addend.m_zeroLimbs * sizeof(std::uint64_t));
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::Add(std::uint64_t _addend)
+{
+	ReserveHeadroom(std::numeric_limits<std::uint8_t>::max());
+
+	// 0x0102 -> columns[0] += 0x02, columns[1] += 0x01
+	for(std::size_t i = 0; _addend != 0; i++)
+	{
+		if(i == m_columns.size())
+		{
+			m_columns.push_back(0);
+		}
+
+		m_columns[i] += _addend % kBase256;
+		_addend /= kBase256;
+	}
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::Add(const std::vector<sav::Decimal>& _addends)
+{
+	// Grow once for the widest addend instead of on every addition.
+	std::size_t widest = 0;
+	for(auto& it : _addends)
+	{
+		widest = std::max(widest, it.m_digits.size() + it.m_zeroLimbs * sizeof(std::uint64_t));
+	}
+
+	if(widest > m_columns.size())
+	{
+		m_columns.resize(widest, 0);
+	}
+
+	for(auto& it : _addends)
+	{
+		Add(it);
+	}
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::Add(const std::vector<std::uint64_t>& _addends)
+{
+	if(m_columns.size() < sizeof(std::uint64_t))
+	{
+		m_columns.resize(sizeof(std::uint64_t), 0);
+	}
+
+	for(auto it : _addends)
+	{
+		Add(it);
+	}
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::Add(const sav::DecimalAccumulator& _other)
+{
+	if(!_other)
+	{
+		m_status = _other.m_status;
+		return (*this);
+	}
+
+	AddColumns(_other.m_columns, _other.m_columnBound);
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::AddProduct(const sav::Decimal& _lhs, const sav::Decimal& _rhs)
+{
+	if(!_lhs || !_rhs)
+	{
+		m_status = !_lhs ? _lhs.m_status : _rhs.m_status;
+		return (*this);
+	}
+
+	AddDigitsProduct(_lhs.m_digits.data(), _lhs.m_digits.size(), _rhs.m_digits.data(), _rhs.m_digits.size(),
+		(_lhs.m_zeroLimbs + _rhs.m_zeroLimbs) * sizeof(std::uint64_t));
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::AddProduct(const sav::Decimal& _lhs, std::uint64_t _rhs)
+{
+	if(!_lhs)
+	{
+		m_status = _lhs.m_status;
+		return (*this);
+	}
+
+	std::uint8_t rhsDigits[sizeof(std::uint64_t)];
+
+	std::size_t rhsCount = 0;
+	for(; _rhs != 0; rhsCount++)
+	{
+		rhsDigits[rhsCount] = static_cast<std::uint8_t>(_rhs % kBase256);
+		_rhs /= kBase256;
+	}
+
+	AddDigitsProduct(_lhs.m_digits.data(), _lhs.m_digits.size(), rhsDigits, rhsCount, _lhs.m_zeroLimbs * sizeof(std::uint64_t));
+
+	return (*this);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::operator+=(const sav::Decimal& _addend)
+{
+	return Add(_addend);
+}
+
+sav::DecimalAccumulator& sav::DecimalAccumulator::operator+=(std::uint64_t _addend)
+{
+	return Add(_addend);
+}
+
+sav::Decimal sav::DecimalAccumulator::Value() const
+{
+	Decimal result;
+
+	if(!(*this))
+	{
+		result.m_status = m_status;
+		return result;
+	}
+
+	if(m_columns.empty())
+	{
+		return result;
+	}
+
+	result.m_digits.clear();
+	result.m_digits.reserve(m_columns.size() + sizeof(std::uint64_t));
+
+	// Same as PropagateCarries(), but writes digits straight into the result.
+	std::uint64_t carry = 0;
+	for(auto column : m_columns)
+	{
+		column += carry;
+		result.m_digits.push_back(static_cast<std::uint8_t>(column % kBase256));
+		carry = column / kBase256;
+	}
+
+	while(carry != 0)
+	{
+		result.m_digits.push_back(static_cast<std::uint8_t>(carry % kBase256));
+		carry /= kBase256;
+	}
+
+	result.Normalize();
+
+	return result;
+}
+
+void sav::DecimalAccumulator::Reset()
+{
+	std::fill(m_columns.begin(), m_columns.end(), 0);
+	m_columnBound = 0;
+	m_status = DecimalStatus::Ok;
+}
+
+sav::DecimalAccumulator::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+void sav::DecimalAccumulator::ReserveHeadroom(std::uint64_t _perColumn)
+{
+	if(m_columnBound > kColumnLimit || _perColumn > kColumnLimit - m_columnBound)
+	{
+		PropagateCarries();
+	}
+
+	m_columnBound += _perColumn;
+}
+
+void sav::DecimalAccumulator::PropagateCarries()
+{
+	std::uint64_t carry = 0;
+	for(auto& column : m_columns)
+	{
+		column += carry;
+		carry = column / kBase256;
+		column %= kBase256;
+	}
+
+	while(carry != 0)
+	{
+		m_columns.push_back(carry % kBase256);
+		carry /= kBase256;
+	}
+
+	m_columnBound = std::numeric_limits<std::uint8_t>::max();
+}
+
+void sav::DecimalAccumulator::AddDigits(const std::uint8_t* _digits, std::size_t _count, std::size_t _firstColumn)
+{
+	if(_firstColumn + _count > m_columns.size())
+	{
+		m_columns.resize(_firstColumn + _count, 0);
+	}
+
+	std::uint64_t* columns = m_columns.data() + _firstColumn;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		columns[i] += _digits[i];
+	}
+}
+
+void sav::DecimalAccumulator::AddColumns(const std::vector<std::uint64_t>& _columns, std::uint64_t _bound)
+{
+	ReserveHeadroom(_bound);
+
+	if(_columns.size() > m_columns.size())
+	{
+		m_columns.resize(_columns.size(), 0);
+	}
+
+	for(std::size_t i = 0; i < _columns.size(); i++)
+	{
+		m_columns[i] += _columns[i];
+	}
+}
+
+void sav::DecimalAccumulator::AddDigitsProduct(const std::uint8_t* _lhs, std::size_t _lhsCount,
+	const std::uint8_t* _rhs, std::size_t _rhsCount, std::size_t _firstColumn)
+{
+	if(_lhsCount == 0 || _rhsCount == 0)
+	{
+		return;
+	}
+
+	// Column k takes one partial product (at most 255 * 255) for every i + j == k.
+	constexpr std::uint64_t kMaxDigitProduct =
+		std::uint64_t{std::numeric_limits<std::uint8_t>::max()} * std::numeric_limits<std::uint8_t>::max();
+	ReserveHeadroom(kMaxDigitProduct * std::min(_lhsCount, _rhsCount));
+
+	if(_firstColumn + _lhsCount + _rhsCount > m_columns.size())
+	{
+		m_columns.resize(_firstColumn + _lhsCount + _rhsCount, 0);
+	}
+
+	for(std::size_t i = 0; i < _lhsCount; i++)
+	{
+		if(_lhs[i] == 0x00)
+		{
+			continue;
+		}
+
+		std::uint64_t* columns = m_columns.data() + _firstColumn + i;
+		for(std::size_t j = 0; j < _rhsCount; j++)
+		{
+			columns[j] += static_cast<std::uint64_t>(_lhs[i]) * _rhs[j];
+		}
+	}
+}
@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalCharConv.h"
+
+#include "DecimalView.h"
+#include "DecimalKernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	bool IsDigit(char _character)
+	{
+		return _character >= '0' && _character <= '9';
+	}
+
+	// Values of up to this many limbs (below the divide and conquer threshold) are converted in stack scratch.
+	constexpr std::size_t kStackLimbs = 64;
+
+	// Base10LengthBound of kStackLimbs limbs, rounded up.
+	constexpr std::size_t kStackCharacters = kStackLimbs * sav::kernels::kLimbBits * 30103 / 100000 + 2;
+
+	// Values of up to 8 base256 digits, as a native integer.
+	std::uint64_t ToNative(const sav::DecimalView& _view)
+	{
+		std::uint64_t result = 0;
+		for(std::size_t i = _view.Size(); i-- > 0;)
+		{
+			result = (result << std::numeric_limits<std::uint8_t>::digits) | _view.Digits()[i];
+		}
+
+		return result;
+	}
+}
+
+std::to_chars_result sav::to_chars(char* _first, char* _last, const sav::Decimal& _value)
+{
+	DecimalView view{_value};
+
+	// Typical amounts : native conversion, nothing allocated.
+	if(view.ZeroLimbs() == 0 && view.Size() <= sizeof(std::uint64_t))
+	{
+		return std::to_chars(_first, _last, ToNative(view));
+	}
+
+	std::size_t available = _last - _first;
+
+	// Wider values up to kStackLimbs: basecase conversion of a stack copy, straight into the buffer
+	// if it has room for the bound, through stack characters otherwise. Nothing allocated either.
+	const std::size_t count = view.ZeroLimbs() + (view.Size() + kernels::kDigitsPerLimb - 1) / kernels::kDigitsPerLimb;
+	if(count <= kStackLimbs && count <= kernels::Base10Threshold())
+	{
+		kernels::Limb scratch[kStackLimbs] = {};
+		for(std::size_t i = 0; i < view.Size(); i++)
+		{
+			scratch[view.ZeroLimbs() + i / kernels::kDigitsPerLimb] |=
+				static_cast<kernels::Limb>(view.Digits()[i]) << (std::numeric_limits<std::uint8_t>::digits * (i % kernels::kDigitsPerLimb));
+		}
+
+		const std::size_t bound = kernels::Base10LengthBound(kernels::BitLength(scratch, count));
+		char characters[kStackCharacters];
+		char* target = available >= bound ? _first : characters;
+
+		kernels::ToBase10Basecase(scratch, count, target + bound, bound);
+
+		std::size_t zeros = std::find_if(target, target + bound - 1, [](char _character) { return _character != '0'; }) - target;
+		if(bound - zeros > available)
+		{
+			return std::to_chars_result{_last, std::errc::value_too_large};
+		}
+
+		std::memmove(_first, target + zeros, bound - zeros);
+
+		return std::to_chars_result{_first + bound - zeros, std::errc{}};
+	}
+
+	auto limbs = kernels::ToLimbs(view.Digits(), view.Size(), view.ZeroLimbs());
+
+	// Enough room for the bound: convert zero-padded and move the digits to the front,
+	// which saves computing the exact length.
+	std::size_t bound = kernels::Base10LengthBound(kernels::BitLength(limbs));
+	if(available >= bound)
+	{
+		kernels::ToBase10(limbs, _first + bound, bound);
+
+		std::size_t zeros = std::find_if(_first, _first + bound - 1, [](char _character) { return _character != '0'; }) - _first;
+		std::memmove(_first, _first + zeros, bound - zeros);
+
+		return std::to_chars_result{_first + bound - zeros, std::errc{}};
+	}
+
+	std::size_t length = kernels::Base10Length(limbs);
+	if(available < length)
+	{
+		return std::to_chars_result{_last, std::errc::value_too_large};
+	}
+
+	kernels::ToBase10(limbs, _first + length, length);
+
+	return std::to_chars_result{_first + length, std::errc{}};
+}
+
+std::from_chars_result sav::from_chars(const char* _first, const char* _last, sav::Decimal& _value)
+{
+	const char* end = std::find_if_not(_first, _last, IsDigit);
+	if(end == _first)
+	{
+		return std::from_chars_result{_first, std::errc::invalid_argument};
+	}
+
+	_value.m_status = DecimalStatus::Ok;
+
+	// Up to 19 characters fit into a native integer, its digits are written directly into the reused storage.
+	if(end - _first <= std::numeric_limits<std::uint64_t>::digits10)
+	{
+		std::uint64_t value = 0;
+		for(const char* character = _first; character != end; character++)
+		{
+			value = value * 10 + static_cast<std::uint64_t>(*character - '0');
+		}
+
+		_value.m_digits.clear();
+		_value.m_zeroLimbs = 0;
+		do
+		{
+			_value.m_digits.push_back(static_cast<std::uint8_t>(value));
+			value >>= std::numeric_limits<std::uint8_t>::digits;
+		}
+		while(value != 0);
+	}
+	else
+	{
+		_value.AssignLimbs(kernels::FromBase10(_first, end - _first));
+	}
+
+	return std::from_chars_result{end, std::errc{}};
+}
+
+std::from_chars_result sav::from_chars(std::string_view _text, sav::Decimal& _value)
+{
+	return from_chars(_text.data(), _text.data() + _text.size(), _value);
+}
+
+std::size_t sav::to_chars_length(const sav::Decimal& _value)
+{
+	DecimalView view{_value};
+
+	if(view.ZeroLimbs() == 0 && view.Size() <= sizeof(std::uint64_t))
+	{
+		std::size_t length = 1;
+		for(std::uint64_t value = ToNative(view); value >= 10; value /= 10)
+		{
+			length++;
+		}
+
+		return length;
+	}
+
+	return kernels::Base10Length(kernels::ToLimbs(view.Digits(), view.Size(), view.ZeroLimbs()));
+}
+
+std::size_t sav::to_chars_max_length(const sav::Decimal& _value) noexcept
+{
+	DecimalView view{_value};
+
+	return kernels::Base10LengthBound((view.Size() + view.ZeroLimbs() * sizeof(std::uint64_t)) * std::numeric_limits<std::uint8_t>::digits);
+}
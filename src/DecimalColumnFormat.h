@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALCOLUMNFORMAT_H
+#define DECIMAL_VLN_BCD_DECIMALCOLUMNFORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * Internal description of the columnar file shared by DecimalColumnWriter and DecimalColumnReader.
+	 * All integers are little-endian.
+	 *
+	 * Header (kHeaderSize bytes):
+	 *   0  magic "DVLNCOL\0"
+	 *   8  uint32 version
+	 *   12 uint32 slot size
+	 *   16 uint64 count of values
+	 *   24 uint64 offset of the slots
+	 *   32 uint64 offset of the overflow heap
+	 *   40 uint64 size of the overflow heap
+	 *
+	 * Slots (count * kSlotSize bytes) are the offset index, value i is at slots + i * kSlotSize:
+	 *   - byte 0 <= kInlineDigits : count of base256 digits stored inline in bytes 1..15;
+	 *   - byte 0 == kOverflowTag  : bytes 8..15 are the offset of the value in the heap.
+	 * The heap is a sequence of Decimal::Serialize encodings.
+	 */
+	namespace columns
+	{
+		enum : std::size_t
+		{
+			kVersion = 1,
+			kHeaderSize = 64,
+			kSlotSize = 16,
+			kInlineDigits = kSlotSize - 1,
+			kOverflowTag = 0xFF,
+			kHeapOffsetPosition = 8
+		};
+
+		constexpr char kMagic[8] = {'D', 'V', 'L', 'N', 'C', 'O', 'L', '\0'};
+
+		inline void Store(std::uint8_t* _destination, std::uint64_t _value, std::size_t _bytes)
+		{
+			for(std::size_t i = 0; i < _bytes; i++)
+			{
+				_destination[i] = static_cast<std::uint8_t>(_value >> (8 * i));
+			}
+		}
+
+		inline std::uint64_t Load(const std::uint8_t* _source, std::size_t _bytes)
+		{
+			std::uint64_t result = 0;
+
+			for(std::size_t i = 0; i < _bytes; i++)
+			{
+				result |= static_cast<std::uint64_t>(_source[i]) << (8 * i);
+			}
+
+			return result;
+		}
+	}
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALCOLUMNFORMAT_H
@@ -0,0 +1,181 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalColumnReader.h"
+
+#include "DecimalColumnFormat.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+	#include <fstream>
+	#include <iterator>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+sav::DecimalColumnReader::DecimalColumnReader(const std::string& _path)
+{
+#if defined(_WIN32)
+	std::ifstream file(_path, std::ios::binary);
+	if(!file)
+	{
+		m_status = DecimalStatus::Error_IO;
+		return;
+	}
+
+	m_buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+	m_data = m_buffer.data();
+	m_size = m_buffer.size();
+#else
+	int descriptor = ::open(_path.c_str(), O_RDONLY);
+	if(descriptor < 0)
+	{
+		m_status = DecimalStatus::Error_IO;
+		return;
+	}
+
+	struct stat info{};
+	if(::fstat(descriptor, &info) != 0)
+	{
+		m_status = DecimalStatus::Error_IO;
+		::close(descriptor);
+		return;
+	}
+
+	// Too short for a header (also avoids mapping an empty file).
+	if(info.st_size < static_cast<off_t>(columns::kHeaderSize))
+	{
+		m_status = DecimalStatus::Error_InvalidArgument;
+		::close(descriptor);
+		return;
+	}
+
+	void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	// The mapping keeps its own reference to the file.
+	::close(descriptor);
+
+	if(mapping == MAP_FAILED)
+	{
+		m_status = DecimalStatus::Error_IO;
+		return;
+	}
+
+	m_data = static_cast<const std::uint8_t*>(mapping);
+	m_size = static_cast<std::size_t>(info.st_size);
+#endif
+
+	m_status = ReadHeader();
+}
+
+sav::DecimalColumnReader::~DecimalColumnReader()
+{
+#if !defined(_WIN32)
+	if(m_data != nullptr)
+	{
+		::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+	}
+#endif
+}
+
+sav::DecimalColumnReader::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalColumnReader::Status() const noexcept
+{
+	return m_status;
+}
+
+std::uint64_t sav::DecimalColumnReader::Size() const noexcept
+{
+	return m_status == DecimalStatus::Ok ? m_count : 0;
+}
+
+sav::DecimalView sav::DecimalColumnReader::operator[](std::uint64_t _index) const noexcept
+{
+	DecimalView result;
+	At(_index, result);
+
+	return result;
+}
+
+sav::DecimalStatus sav::DecimalColumnReader::At(std::uint64_t _index, sav::DecimalView& _view) const noexcept
+{
+	if(_index >= Size())
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	const std::uint8_t* slot = m_data + columns::kHeaderSize + _index * columns::kSlotSize;
+
+	if(slot[0] <= columns::kInlineDigits)
+	{
+		_view = DecimalView{slot + 1, slot[0]};
+		return DecimalStatus::Ok;
+	}
+
+	std::uint64_t offset = columns::Load(slot + columns::kHeapOffsetPosition, sizeof(std::uint64_t));
+
+	if(slot[0] != columns::kOverflowTag || offset >= m_heapSize
+		|| DecimalView::Parse(m_heap + offset, static_cast<std::size_t>(m_heapSize - offset), _view) == 0)
+	{
+		_view = DecimalView{};
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	return DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalColumnReader::ReadHeader() noexcept
+{
+	if(m_size < columns::kHeaderSize || !std::equal(std::begin(columns::kMagic), std::end(columns::kMagic), m_data))
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	std::uint64_t version = columns::Load(m_data + 8, sizeof(std::uint32_t));
+	std::uint64_t slotSize = columns::Load(m_data + 12, sizeof(std::uint32_t));
+	std::uint64_t count = columns::Load(m_data + 16, sizeof(std::uint64_t));
+	std::uint64_t slotsOffset = columns::Load(m_data + 24, sizeof(std::uint64_t));
+	std::uint64_t heapOffset = columns::Load(m_data + 32, sizeof(std::uint64_t));
+	std::uint64_t heapSize = columns::Load(m_data + 40, sizeof(std::uint64_t));
+
+	// Sections must follow each other exactly and fill the file (written by Close(), so no truncation).
+	if(version != columns::kVersion || slotSize != columns::kSlotSize || slotsOffset != columns::kHeaderSize
+		|| count > (m_size - columns::kHeaderSize) / columns::kSlotSize
+		|| heapOffset != columns::kHeaderSize + count * columns::kSlotSize
+		|| heapSize != m_size - heapOffset)
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	m_count = count;
+	m_heap = m_data + heapOffset;
+	m_heapSize = heapSize;
+
+	return DecimalStatus::Ok;
+}
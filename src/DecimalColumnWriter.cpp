@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalColumnWriter.h"
+
+#include "DecimalColumnFormat.h"
+
+#include <algorithm>
+
+sav::DecimalColumnWriter::DecimalColumnWriter(const std::string& _path)
+	:	m_file(_path, std::ios::binary | std::ios::trunc)
+{
+	// Header placeholder, rewritten by Close() once the count and the heap size are known.
+	char header[columns::kHeaderSize] = {};
+	m_file.write(header, sizeof(header));
+
+	if(!m_file)
+	{
+		m_status = DecimalStatus::Error_IO;
+	}
+}
+
+sav::DecimalColumnWriter::~DecimalColumnWriter()
+{
+	Close();
+}
+
+sav::DecimalColumnWriter::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalColumnWriter::Append(const sav::Decimal& _value)
+{
+	if(!_value)
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	return Append(DecimalView{_value});
+}
+
+sav::DecimalStatus sav::DecimalColumnWriter::Append(const sav::DecimalView& _value)
+{
+	if(m_status != DecimalStatus::Ok || m_closed)
+	{
+		return DecimalStatus::Error_IO;
+	}
+
+	std::uint8_t slot[columns::kSlotSize] = {};
+
+	// implicit zero limbs of the value are written out (the slot is zero-filled)
+	const std::size_t zeros = _value.ZeroLimbs() * sizeof(std::uint64_t);
+
+	if(zeros + _value.Size() <= columns::kInlineDigits)
+	{
+		slot[0] = static_cast<std::uint8_t>(zeros + _value.Size());
+		std::copy(_value.Digits(), _value.Digits() + _value.Size(), slot + 1 + zeros);
+	}
+	else
+	{
+		slot[0] = columns::kOverflowTag;
+		columns::Store(slot + columns::kHeapOffsetPosition, m_heap.size(), sizeof(std::uint64_t));
+		_value.Serialize(m_heap);
+	}
+
+	m_file.write(reinterpret_cast<const char*>(slot), sizeof(slot));
+
+	if(!m_file)
+	{
+		m_status = DecimalStatus::Error_IO;
+		return m_status;
+	}
+
+	m_count++;
+
+	return DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalColumnWriter::Close()
+{
+	if(m_closed)
+	{
+		return m_status;
+	}
+
+	m_closed = true;
+
+	if(m_status != DecimalStatus::Ok)
+	{
+		return m_status;
+	}
+
+	std::uint64_t heapOffset = columns::kHeaderSize + m_count * columns::kSlotSize;
+
+	m_file.write(reinterpret_cast<const char*>(m_heap.data()), m_heap.size());
+
+	std::uint8_t header[columns::kHeaderSize] = {};
+	std::copy(std::begin(columns::kMagic), std::end(columns::kMagic), header);
+	columns::Store(header + 8, columns::kVersion, sizeof(std::uint32_t));
+	columns::Store(header + 12, columns::kSlotSize, sizeof(std::uint32_t));
+	columns::Store(header + 16, m_count, sizeof(std::uint64_t));
+	columns::Store(header + 24, columns::kHeaderSize, sizeof(std::uint64_t));
+	columns::Store(header + 32, heapOffset, sizeof(std::uint64_t));
+	columns::Store(header + 40, m_heap.size(), sizeof(std::uint64_t));
+
+	m_file.seekp(0);
+	m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+	m_file.close();
+
+	if(!m_file)
+	{
+		m_status = DecimalStatus::Error_IO;
+	}
+
+	m_heap = std::vector<std::uint8_t>{};
+
+	return m_status;
+}
+
+std::uint64_t sav::DecimalColumnWriter::Count() const noexcept
+{
+	return m_count;
+}
@@ -0,0 +1,253 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalConcurrentAccumulator.h"
+
+#include <algorithm>
+#include <thread>
+
+sav::DecimalConcurrentAccumulator::DecimalConcurrentAccumulator(std::size_t _shards, std::size_t _digits)
+	:	m_limbs((std::max<std::size_t>(_digits, sizeof(std::uint64_t)) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t)),
+		m_shardLines((2 * m_limbs + kLineColumns - 1) / kLineColumns),
+		m_shards(_shards != 0 ? _shards : std::max(1u, std::thread::hardware_concurrency())),
+		m_lines(new ColumnLine[m_shards.size() * m_shardLines]())
+{
+
+}
+
+void sav::DecimalConcurrentAccumulator::Add(const sav::Decimal& _addend)
+{
+	if(!_addend)
+	{
+		m_status.store(_addend.m_status, std::memory_order_relaxed);
+		return;
+	}
+
+	if(_addend.EqualsZero())
+	{
+		return;
+	}
+
+	const std::uint8_t* digits = _addend.m_digits.data();
+	const std::size_t count = _addend.m_digits.size();
+
+	if(_addend.m_zeroLimbs + (count + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t) > m_limbs)
+	{
+		std::lock_guard<std::mutex> lock{m_overflowMutex};
+		m_overflow.Add(_addend);
+		return;
+	}
+
+	const std::size_t shard = BeginAddition();
+
+	for(std::size_t limb = _addend.m_zeroLimbs, i = 0; i < count; limb++, i += sizeof(std::uint64_t))
+	{
+		std::uint64_t value = 0;
+		for(std::size_t j = std::min(count, i + sizeof(std::uint64_t)); j-- > i; )
+		{
+			value = (value << std::numeric_limits<std::uint8_t>::digits) | digits[j];
+		}
+
+		AddLimb(shard, limb, value);
+	}
+
+	EndAddition(shard);
+}
+
+void sav::DecimalConcurrentAccumulator::Add(std::uint64_t _addend)
+{
+	// Adding zero, nothing to announce.
+	if(_addend == 0)
+	{
+		return;
+	}
+
+	const std::size_t shard = BeginAddition();
+	AddLimb(shard, 0, _addend);
+	EndAddition(shard);
+}
+
+sav::DecimalConcurrentAccumulator& sav::DecimalConcurrentAccumulator::operator+=(const sav::Decimal& _addend)
+{
+	Add(_addend);
+
+	return (*this);
+}
+
+sav::DecimalConcurrentAccumulator& sav::DecimalConcurrentAccumulator::operator+=(std::uint64_t _addend)
+{
+	Add(_addend);
+
+	return (*this);
+}
+
+sav::Decimal sav::DecimalConcurrentAccumulator::Value() const
+{
+	DecimalAccumulator total;
+
+	{
+		std::lock_guard<std::mutex> lock{m_overflowMutex};
+		total.Add(m_overflow);
+	}
+
+	std::vector<std::uint64_t> limbs(m_limbs);
+	std::vector<std::uint64_t> carries(m_limbs);
+
+	// Base256 digits of the limb columns and of the carry columns (which weigh as much as the next limb),
+	// so a column of the total takes at most two digits.
+	std::vector<std::uint64_t> columns((m_limbs + 1) * sizeof(std::uint64_t));
+	constexpr std::uint64_t kColumnBound = 2 * std::numeric_limits<std::uint8_t>::max();
+
+	for(std::size_t shard = 0; shard < m_shards.size(); shard++)
+	{
+		bool waiting = false;
+
+		for(std::size_t attempt = 1; !ReadShard(shard, limbs, carries); attempt++)
+		{
+			// Writers keep the shard busy: hold back new additions until it has been read.
+			if(attempt == kOptimisticReads)
+			{
+				m_shards[shard].m_waitingReaders.fetch_add(1, std::memory_order_relaxed);
+				waiting = true;
+			}
+
+			std::this_thread::yield();
+		}
+
+		if(waiting)
+		{
+			m_shards[shard].m_waitingReaders.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		std::fill(columns.begin(), columns.end(), 0);
+
+		for(std::size_t i = 0; i < m_limbs; i++)
+		{
+			for(std::size_t j = 0; j < sizeof(std::uint64_t); j++)
+			{
+				const auto shift = j * std::numeric_limits<std::uint8_t>::digits;
+				columns[i * sizeof(std::uint64_t) + j] += static_cast<std::uint8_t>(limbs[i] >> shift);
+				columns[(i + 1) * sizeof(std::uint64_t) + j] += static_cast<std::uint8_t>(carries[i] >> shift);
+			}
+		}
+
+		total.AddColumns(columns, kColumnBound);
+	}
+
+	auto status = m_status.load(std::memory_order_relaxed);
+	if(status != DecimalStatus::Ok)
+	{
+		Decimal result;
+		result.m_status = status;
+		return result;
+	}
+
+	return total.Value();
+}
+
+void sav::DecimalConcurrentAccumulator::Reset()
+{
+	for(std::size_t shard = 0; shard < m_shards.size(); shard++)
+	{
+		for(std::size_t i = 0; i < 2 * m_limbs; i++)
+		{
+			Column(shard, i).store(0, std::memory_order_relaxed);
+		}
+
+		m_shards[shard].m_started.store(0, std::memory_order_relaxed);
+		m_shards[shard].m_finished.store(0, std::memory_order_relaxed);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{m_overflowMutex};
+		m_overflow.Reset();
+	}
+
+	m_status.store(DecimalStatus::Ok, std::memory_order_release);
+}
+
+std::size_t sav::DecimalConcurrentAccumulator::CurrentShard() const
+{
+	static std::atomic<std::size_t> nextThreadIndex{0};
+	thread_local std::size_t threadIndex = nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+	return threadIndex % m_shards.size();
+}
+
+std::atomic<std::uint64_t>& sav::DecimalConcurrentAccumulator::Column(std::size_t _shard, std::size_t _column) const
+{
+	return m_lines[_shard * m_shardLines + _column / kLineColumns].m_columns[_column % kLineColumns];
+}
+
+std::size_t sav::DecimalConcurrentAccumulator::BeginAddition()
+{
+	const std::size_t shard = CurrentShard();
+
+	// A reader gave up on optimistic reads of the shard, let it finish first.
+	while(m_shards[shard].m_waitingReaders.load(std::memory_order_relaxed) != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	m_shards[shard].m_started.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	return shard;
+}
+
+void sav::DecimalConcurrentAccumulator::EndAddition(std::size_t _shard)
+{
+	m_shards[_shard].m_finished.fetch_add(1, std::memory_order_release);
+}
+
+void sav::DecimalConcurrentAccumulator::AddLimb(std::size_t _shard, std::size_t _limb, std::uint64_t _value)
+{
+	if(_value == 0)
+	{
+		return;
+	}
+
+	// The column keeps the sum modulo 2^64, its carry column counts the wraps.
+	const std::uint64_t previous = Column(_shard, _limb).fetch_add(_value, std::memory_order_relaxed);
+	if(previous + _value < previous)
+	{
+		Column(_shard, m_limbs + _limb).fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+bool sav::DecimalConcurrentAccumulator::ReadShard(std::size_t _shard, std::vector<std::uint64_t>& _limbs,
+	std::vector<std::uint64_t>& _carries) const
+{
+	auto finished = m_shards[_shard].m_finished.load(std::memory_order_acquire);
+
+	for(std::size_t i = 0; i < m_limbs; i++)
+	{
+		_limbs[i] = Column(_shard, i).load(std::memory_order_relaxed);
+		_carries[i] = Column(_shard, m_limbs + i).load(std::memory_order_relaxed);
+	}
+
+	std::atomic_thread_fence(std::memory_order_acquire);
+	auto started = m_shards[_shard].m_started.load(std::memory_order_relaxed);
+
+	// No addition was in flight while the columns were read.
+	return started == finished;
+}
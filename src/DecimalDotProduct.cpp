@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalDotProduct.h"
+
+#include "DecimalAccumulator.h"
+
+namespace
+{
+	template<typename T>
+	sav::Decimal AccumulateProducts(const sav::Decimal* _lhs, const T* _rhs, std::size_t _count)
+	{
+		sav::DecimalAccumulator accumulator;
+
+		for(std::size_t i = 0; i < _count; i++)
+		{
+			accumulator.AddProduct(_lhs[i], _rhs[i]);
+		}
+
+		return accumulator.Value();
+	}
+}
+
+sav::Decimal sav::DotProduct(const sav::Decimal* _lhs, const sav::Decimal* _rhs, std::size_t _count)
+{
+	return AccumulateProducts(_lhs, _rhs, _count);
+}
+
+sav::Decimal sav::DotProduct(const sav::Decimal* _lhs, const std::uint64_t* _rhs, std::size_t _count)
+{
+	return AccumulateProducts(_lhs, _rhs, _count);
+}
+
+sav::Decimal sav::DotProduct(const std::vector<sav::Decimal>& _lhs, const std::vector<sav::Decimal>& _rhs)
+{
+	if(_lhs.size() != _rhs.size())
+	{
+		Decimal result;
+		result.m_status = DecimalStatus::Error_InvalidArgument;
+		return result;
+	}
+
+	return AccumulateProducts(_lhs.data(), _rhs.data(), _lhs.size());
+}
+
+sav::Decimal sav::DotProduct(const std::vector<sav::Decimal>& _lhs, const std::vector<std::uint64_t>& _rhs)
+{
+	if(_lhs.size() != _rhs.size())
+	{
+		Decimal result;
+		result.m_status = DecimalStatus::Error_InvalidArgument;
+		return result;
+	}
+
+	return AccumulateProducts(_lhs.data(), _rhs.data(), _lhs.size());
+}
@@ -0,0 +1,261 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalInstrumentation.h"
+
+#ifdef DECIMAL_VLN_BCD_INSTRUMENTATION
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+	#include <x86intrin.h>
+#else
+	#include <chrono>
+#endif
+
+namespace
+{
+	constexpr std::size_t kOperations = static_cast<std::size_t>(sav::DecimalOperation::Count);
+
+	using Counter = std::atomic<std::uint64_t>;
+
+	// Only the owning thread writes, so a relaxed load and store is enough (no locked instruction).
+	void Increment(Counter& _counter, std::uint64_t _value) noexcept
+	{
+		_counter.store(_counter.load(std::memory_order_relaxed) + _value, std::memory_order_relaxed);
+	}
+
+	std::uint64_t Ticks() noexcept
+	{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+		return __rdtsc();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	struct OperationCounters
+	{
+		Counter m_calls{0};
+		Counter m_cycles{0};
+		std::array<Counter, sav::DecimalOperationCounters::kHistogramBuckets> m_histogram{};
+	};
+
+	struct ThreadCounters
+	{
+		ThreadCounters();
+		~ThreadCounters();
+
+		std::array<OperationCounters, kOperations> m_operations;
+
+		Counter m_bufferAllocations{0};
+		Counter m_bufferCopies{0};
+	};
+
+	struct Registry
+	{
+		std::mutex m_mutex;
+
+		std::vector<ThreadCounters*> m_threads;
+
+		// Counts of exited threads.
+		sav::DecimalInstrumentationSnapshot m_retired;
+	};
+
+	Registry& GetRegistry()
+	{
+		// Never destroyed: thread_local counters may be destroyed after static objects.
+		static Registry* registry = new Registry;
+		return *registry;
+	}
+
+	void Accumulate(sav::DecimalInstrumentationSnapshot& _snapshot, const ThreadCounters& _counters)
+	{
+		for(std::size_t i = 0; i < kOperations; i++)
+		{
+			auto& operation = _snapshot.Operations[i];
+			const auto& counters = _counters.m_operations[i];
+
+			operation.Calls += counters.m_calls.load(std::memory_order_relaxed);
+			operation.Cycles += counters.m_cycles.load(std::memory_order_relaxed);
+			for(std::size_t bucket = 0; bucket < operation.LimbHistogram.size(); bucket++)
+			{
+				operation.LimbHistogram[bucket] += counters.m_histogram[bucket].load(std::memory_order_relaxed);
+			}
+		}
+
+		_snapshot.BufferAllocations += _counters.m_bufferAllocations.load(std::memory_order_relaxed);
+		_snapshot.BufferCopies += _counters.m_bufferCopies.load(std::memory_order_relaxed);
+	}
+
+	void Clear(ThreadCounters& _counters)
+	{
+		for(auto& operation : _counters.m_operations)
+		{
+			operation.m_calls.store(0, std::memory_order_relaxed);
+			operation.m_cycles.store(0, std::memory_order_relaxed);
+			for(auto& bucket : operation.m_histogram)
+			{
+				bucket.store(0, std::memory_order_relaxed);
+			}
+		}
+
+		_counters.m_bufferAllocations.store(0, std::memory_order_relaxed);
+		_counters.m_bufferCopies.store(0, std::memory_order_relaxed);
+	}
+
+	ThreadCounters::ThreadCounters()
+	{
+		auto& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock{registry.m_mutex};
+		registry.m_threads.push_back(this);
+	}
+
+	ThreadCounters::~ThreadCounters()
+	{
+		auto& registry = GetRegistry();
+		std::lock_guard<std::mutex> lock{registry.m_mutex};
+		Accumulate(registry.m_retired, *this);
+		registry.m_threads.erase(std::find(registry.m_threads.begin(), registry.m_threads.end(), this));
+	}
+
+	ThreadCounters& LocalCounters()
+	{
+		thread_local ThreadCounters counters;
+		return counters;
+	}
+
+	std::size_t HistogramBucket(std::size_t _digits) noexcept
+	{
+		std::size_t limbs = std::max<std::size_t>((_digits + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t), 1);
+
+		std::size_t bucket = 0;
+		while(limbs > 1 && bucket + 1 < sav::DecimalOperationCounters::kHistogramBuckets)
+		{
+			limbs >>= 1;
+			bucket++;
+		}
+
+		return bucket;
+	}
+}
+
+void sav::instrumentation::CountBuffer(bool _copy) noexcept
+{
+	auto& counters = LocalCounters();
+
+	Increment(counters.m_bufferAllocations, 1);
+	if(_copy)
+	{
+		Increment(counters.m_bufferCopies, 1);
+	}
+}
+
+sav::instrumentation::Scope::Scope(sav::DecimalOperation _operation, std::size_t _digits) noexcept
+	:	m_operation(_operation)
+{
+	auto& counters = LocalCounters().m_operations[static_cast<std::size_t>(_operation)];
+
+	Increment(counters.m_calls, 1);
+	Increment(counters.m_histogram[HistogramBucket(_digits)], 1);
+
+	m_start = Ticks();
+}
+
+sav::instrumentation::Scope::~Scope()
+{
+	std::uint64_t elapsed = Ticks() - m_start;
+
+	Increment(LocalCounters().m_operations[static_cast<std::size_t>(m_operation)].m_cycles, elapsed);
+}
+
+#endif
+
+const sav::DecimalOperationCounters& sav::DecimalInstrumentationSnapshot::operator[](sav::DecimalOperation _operation) const noexcept
+{
+	return Operations[static_cast<std::size_t>(_operation)];
+}
+
+bool sav::DecimalInstrumentation::Enabled() noexcept
+{
+#ifdef DECIMAL_VLN_BCD_INSTRUMENTATION
+	return true;
+#else
+	return false;
+#endif
+}
+
+sav::DecimalInstrumentationSnapshot sav::DecimalInstrumentation::Snapshot()
+{
+	DecimalInstrumentationSnapshot result;
+
+#ifdef DECIMAL_VLN_BCD_INSTRUMENTATION
+	auto& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock{registry.m_mutex};
+
+	result = registry.m_retired;
+	for(const auto* counters : registry.m_threads)
+	{
+		Accumulate(result, *counters);
+	}
+#endif
+
+	return result;
+}
+
+void sav::DecimalInstrumentation::Reset()
+{
+#ifdef DECIMAL_VLN_BCD_INSTRUMENTATION
+	auto& registry = GetRegistry();
+	std::lock_guard<std::mutex> lock{registry.m_mutex};
+
+	registry.m_retired = DecimalInstrumentationSnapshot{};
+	for(auto* counters : registry.m_threads)
+	{
+		Clear(*counters);
+	}
+#endif
+}
+
+const char* sav::DecimalInstrumentation::Name(sav::DecimalOperation _operation) noexcept
+{
+	switch(_operation)
+	{
+		case DecimalOperation::Construct: return "Construct";
+		case DecimalOperation::SetFromString: return "SetFromString";
+		case DecimalOperation::ToString: return "ToString";
+		case DecimalOperation::Add: return "Add";
+		case DecimalOperation::Subtract: return "Subtract";
+		case DecimalOperation::Multiply: return "Multiply";
+		case DecimalOperation::Divide: return "Divide";
+		case DecimalOperation::DivideAndRound: return "DivideAndRound";
+		case DecimalOperation::DivExact: return "DivExact";
+		case DecimalOperation::Square: return "Square";
+		case DecimalOperation::Pow: return "Pow";
+		case DecimalOperation::Gcd: return "Gcd";
+		case DecimalOperation::Compare: return "Compare";
+		default: return "Unknown";
+	}
+}
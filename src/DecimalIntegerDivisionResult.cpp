@@ -22,7 +22,7 @@
 
 #include <DecimalIntegerDivisionResult.h>
 
-sav::DecimalIntegerDivisionResult::operator bool() const
+sav::DecimalIntegerDivisionResult::operator bool() const noexcept
 {
 	return m_divisionStatus == DecimalStatus::Ok;
 }
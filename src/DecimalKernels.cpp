@@ -0,0 +1,1422 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalKernels.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	using sav::kernels::Limb;
+	using sav::kernels::Limbs;
+
+	constexpr Limb kLimbMax = std::numeric_limits<Limb>::max();
+
+	unsigned int CountLeadingZeros(Limb _limb)
+	{
+		unsigned int count = 0;
+		for(Limb mask = Limb{1} << (sav::kernels::kLimbBits - 1); mask != 0 && (_limb & mask) == 0; mask >>= 1)
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	std::size_t EffectiveSize(const Limb* _limbs, std::size_t _count)
+	{
+		while(_count != 0 && _limbs[_count - 1] == 0)
+		{
+			_count--;
+		}
+
+		return _count;
+	}
+
+	int CompareN(const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+	{
+		for(std::size_t i = _count; i-- > 0;)
+		{
+			if(_lhs[i] != _rhs[i])
+			{
+				return _lhs[i] < _rhs[i] ? -1 : 1;
+			}
+		}
+
+		return 0;
+	}
+
+	// _value * base^_limbs
+	Limbs Shifted(const Limbs& _value, std::size_t _limbs)
+	{
+		Limbs result(_limbs, 0);
+		result.insert(result.end(), _value.begin(), _value.end());
+		return result;
+	}
+
+	// _low (padded to _lowCount limbs) + _high * base^_lowCount
+	Limbs Concatenated(const Limb* _low, std::size_t _lowCount, const Limbs& _high)
+	{
+		Limbs result{_low, _low + _lowCount};
+		result.insert(result.end(), _high.begin(), _high.end());
+		return result;
+	}
+
+	void AddInPlace(Limbs& _lhs, const Limbs& _rhs)
+	{
+		if(_rhs.size() > _lhs.size())
+		{
+			_lhs.resize(_rhs.size(), 0);
+		}
+
+		Limb carry = sav::kernels::Add(_lhs.data(), _lhs.data(), _lhs.size(), _rhs.data(), _rhs.size());
+		if(carry != 0)
+		{
+			_lhs.push_back(carry);
+		}
+	}
+
+	// Requires _lhs >= _rhs.
+	void SubInPlace(Limbs& _lhs, const Limbs& _rhs)
+	{
+		std::size_t rhsCount = EffectiveSize(_rhs.data(), _rhs.size());
+		sav::kernels::Sub(_lhs.data(), _lhs.data(), _lhs.size(), _rhs.data(), rhsCount);
+		sav::kernels::Trim(_lhs);
+	}
+
+	// Requires _value != 0.
+	void Decrement(Limbs& _value)
+	{
+		for(auto& limb : _value)
+		{
+			if(limb-- != 0)
+			{
+				break;
+			}
+		}
+
+		sav::kernels::Trim(_value);
+	}
+
+	/**
+	 * KnuthDivRem - Knuth's algorithm D.
+	 * @param _quotient _dividendCount - _divisorCount + 1 limbs
+	 * @param _dividend replaced with the remainder (in the low _divisorCount limbs)
+	 * @param _divisor normalized (most significant bit set), at least 2 limbs
+	 */
+	void KnuthDivRem(Limb* _quotient, Limb* _dividend, std::size_t _dividendCount,
+		const Limb* _divisor, std::size_t _divisorCount)
+	{
+		const std::size_t n = _divisorCount;
+		const std::size_t m = _dividendCount - n;
+		const Limb divisorTop = _divisor[n - 1];
+		const Limb divisorNext = _divisor[n - 2];
+
+		if(CompareN(_dividend + m, _divisor, n) >= 0)
+		{
+			sav::kernels::SubN(_dividend + m, _dividend + m, _divisor, n);
+			_quotient[m] = 1;
+		}
+		else
+		{
+			_quotient[m] = 0;
+		}
+
+		for(std::size_t j = m; j-- > 0;)
+		{
+			Limb* window = _dividend + j;
+			Limb quotientDigit = kLimbMax;
+
+			// Estimate the quotient digit from the two most significant limbs and refine it with the third one
+			if(window[n] < divisorTop)
+			{
+				Limb remainder = 0;
+				quotientDigit = sav::kernels::DivWide(window[n], window[n - 1], divisorTop, remainder);
+
+				for(;;)
+				{
+					Limb high = 0;
+					Limb low = sav::kernels::MulWide(quotientDigit, divisorNext, high);
+					if(high < remainder || (high == remainder && low <= window[n - 2]))
+					{
+						break;
+					}
+
+					quotientDigit--;
+					Limb previousRemainder = remainder;
+					remainder += divisorTop;
+					if(remainder < previousRemainder)
+					{
+						break;
+					}
+				}
+			}
+
+			Limb borrow = sav::kernels::SubMul1(window, _divisor, n, quotientDigit);
+			Limb top = window[n];
+			window[n] = top - borrow;
+
+			// The estimate was too big (rare): add the divisor back
+			bool negative = top < borrow;
+			while(negative)
+			{
+				quotientDigit--;
+				Limb carry = sav::kernels::AddN(window, window, _divisor, n);
+				top = window[n];
+				window[n] = top + carry;
+				negative = !(window[n] < top);
+			}
+
+			_quotient[j] = quotientDigit;
+		}
+	}
+
+	unsigned int CountTrailingZeros(Limb _limb)
+	{
+		unsigned int count = 0;
+		for(; (_limb & 1) == 0; _limb >>= 1)
+		{
+			count++;
+		}
+
+		return count;
+	}
+
+	// Stein's binary GCD for single limbs.
+	Limb BinaryGcd(Limb _lhs, Limb _rhs)
+	{
+		if(_lhs == 0 || _rhs == 0)
+		{
+			return _lhs | _rhs;
+		}
+
+		unsigned int commonZeros = CountTrailingZeros(_lhs | _rhs);
+		_lhs >>= CountTrailingZeros(_lhs);
+
+		while(_rhs != 0)
+		{
+			_rhs >>= CountTrailingZeros(_rhs);
+			if(_lhs > _rhs)
+			{
+				std::swap(_lhs, _rhs);
+			}
+			_rhs -= _lhs;
+		}
+
+		return _lhs << commonZeros;
+	}
+
+	/**
+	 * @struct LehmerMatrix
+	 * Cofactors of several Euclid steps simulated on the leading bits:
+	 * (a, b) -> (A * a + B * b, C * a + D * b). A and B (as well as C and D) never have the same sign.
+	 */
+	struct LehmerMatrix
+	{
+		std::int64_t A = 1;
+		std::int64_t B = 0;
+		std::int64_t C = 0;
+		std::int64_t D = 1;
+		std::size_t Steps = 0;
+	};
+
+	// Leading bits kept by the simulation, so that hat values plus cofactors still fit into std::int64_t.
+	constexpr std::size_t kLehmerBits = 62;
+
+	// (_value >> _shift) & (2^64 - 1)
+	Limb ExtractBits(const Limbs& _value, std::size_t _shift)
+	{
+		std::size_t index = _shift / sav::kernels::kLimbBits;
+		unsigned int bits = _shift % sav::kernels::kLimbBits;
+
+		Limb result = index < _value.size() ? _value[index] >> bits : 0;
+		if(bits != 0 && index + 1 < _value.size())
+		{
+			result |= _value[index + 1] << (sav::kernels::kLimbBits - bits);
+		}
+
+		return result;
+	}
+
+	// Knuth's algorithm L: run Euclid on the leading bits while both quotient estimates agree. Requires _lhs >= _rhs.
+	LehmerMatrix SimulateLehmer(const Limbs& _lhs, const Limbs& _rhs)
+	{
+		LehmerMatrix matrix;
+
+		std::size_t shift = sav::kernels::BitLength(_lhs) - kLehmerBits;
+		auto x = static_cast<std::int64_t>(ExtractBits(_lhs, shift));
+		auto y = static_cast<std::int64_t>(ExtractBits(_rhs, shift));
+
+		while(y + matrix.C != 0 && y + matrix.D != 0)
+		{
+			std::int64_t quotient = (x + matrix.A) / (y + matrix.C);
+			if(quotient != (x + matrix.B) / (y + matrix.D))
+			{
+				break;
+			}
+
+			std::int64_t temporary = matrix.A - quotient * matrix.C;
+			matrix.A = matrix.C;
+			matrix.C = temporary;
+
+			temporary = matrix.B - quotient * matrix.D;
+			matrix.B = matrix.D;
+			matrix.D = temporary;
+
+			temporary = x - quotient * y;
+			x = y;
+			y = temporary;
+
+			matrix.Steps++;
+		}
+
+		return matrix;
+	}
+
+	// _x * _u + _y * _v, which is known to be non-negative.
+	Limbs Combine(const Limbs& _u, const Limbs& _v, std::int64_t _x, std::int64_t _y)
+	{
+		const std::size_t count = std::max(_u.size(), _v.size());
+		Limbs u{_u};
+		Limbs v{_v};
+		u.resize(count, 0);
+		v.resize(count, 0);
+
+		// Start from the non-negative term
+		if(_x < 0)
+		{
+			std::swap(u, v);
+			std::swap(_x, _y);
+		}
+
+		Limbs result(count + 1, 0);
+		result[count] = sav::kernels::Mul1(result.data(), u.data(), count, static_cast<Limb>(_x));
+		if(_y >= 0)
+		{
+			result[count] += sav::kernels::AddMul1(result.data(), v.data(), count, static_cast<Limb>(_y));
+		}
+		else
+		{
+			result[count] -= sav::kernels::SubMul1(result.data(), v.data(), count, static_cast<Limb>(-_y));
+		}
+
+		sav::kernels::Trim(result);
+		return result;
+	}
+
+	std::int64_t Magnitude(std::int64_t _value)
+	{
+		return _value < 0 ? -_value : _value;
+	}
+
+	/**
+	 * RecursiveDivRem - Burnikel-Ziegler recursive division (as in Brent & Zimmermann, "Modern Computer Arithmetic").
+	 * @param _dividend n + m limbs, less than 2 * base^m * _divisor
+	 * @param _divisor n limbs, normalized, m <= n
+	 */
+	void RecursiveDivRem(const Limbs& _dividend, const Limbs& _divisor, Limbs& _quotient, Limbs& _remainder)
+	{
+		const std::size_t n = _divisor.size();
+		const std::size_t m = _dividend.size() - n;
+
+		if(m < sav::kernels::BurnikelZieglerThreshold())
+		{
+			_remainder = _dividend;
+			_quotient.assign(m + 1, 0);
+			KnuthDivRem(_quotient.data(), _remainder.data(), _remainder.size(), _divisor.data(), n);
+			_remainder.resize(n);
+			sav::kernels::Trim(_quotient);
+			sav::kernels::Trim(_remainder);
+			return;
+		}
+
+		// Make sure that dividend < base^m * divisor, so that the halves below have the right size.
+		Limbs dividend = _dividend;
+		bool quotientTopLimb = false;
+		if(CompareN(dividend.data() + m, _divisor.data(), n) >= 0)
+		{
+			sav::kernels::SubN(dividend.data() + m, dividend.data() + m, _divisor.data(), n);
+			quotientTopLimb = true;
+		}
+
+		const std::size_t k = m / 2;
+		const Limbs divisorHigh{_divisor.begin() + k, _divisor.end()};
+		Limbs divisorLow{_divisor.begin(), _divisor.begin() + k};
+		sav::kernels::Trim(divisorLow);
+
+		// High half of the quotient: (dividend / base^2k) / (divisor / base^k)
+		Limbs quotientHigh;
+		Limbs remainderHigh;
+		RecursiveDivRem(Limbs{dividend.begin() + 2 * k, dividend.end()}, divisorHigh, quotientHigh, remainderHigh);
+
+		Limbs intermediate = Concatenated(dividend.data(), 2 * k, remainderHigh);
+		Limbs correction = Shifted(sav::kernels::Multiply(quotientHigh, divisorLow), k);
+		while(sav::kernels::Compare(intermediate, correction) < 0)
+		{
+			Decrement(quotientHigh);
+			AddInPlace(intermediate, Shifted(_divisor, k));
+		}
+		SubInPlace(intermediate, correction);
+
+		// Low half of the quotient: (intermediate / base^k) / (divisor / base^k)
+		Limbs intermediateHigh{intermediate.size() > k ? intermediate.begin() + k : intermediate.end(), intermediate.end()};
+		intermediateHigh.resize(n, 0);
+		intermediate.resize(std::max(intermediate.size(), k), 0);
+
+		Limbs quotientLow;
+		Limbs remainderLow;
+		RecursiveDivRem(intermediateHigh, divisorHigh, quotientLow, remainderLow);
+
+		_remainder = Concatenated(intermediate.data(), k, remainderLow);
+		correction = sav::kernels::Multiply(quotientLow, divisorLow);
+		while(sav::kernels::Compare(_remainder, correction) < 0)
+		{
+			Decrement(quotientLow);
+			AddInPlace(_remainder, _divisor);
+		}
+		SubInPlace(_remainder, correction);
+
+		_quotient = Shifted(quotientHigh, k);
+		AddInPlace(_quotient, quotientLow);
+		if(quotientTopLimb)
+		{
+			AddInPlace(_quotient, Shifted(Limbs{1}, m));
+		}
+		sav::kernels::Trim(_quotient);
+	}
+
+	/**
+	 * Kernels selected once, by CPUID, on first use
+	 * (a function local static, so that static Decimals of other translation units can use them safely).
+	 */
+	struct KernelTable
+	{
+		Limb (*m_addN)(Limb*, const Limb*, const Limb*, std::size_t);
+		Limb (*m_subN)(Limb*, const Limb*, const Limb*, std::size_t);
+		Limb (*m_mul1)(Limb*, const Limb*, std::size_t, Limb);
+		Limb (*m_addMul1)(Limb*, const Limb*, std::size_t, Limb);
+		const char* m_name;
+	};
+
+	const KernelTable& Kernels()
+	{
+		namespace kernels = sav::kernels;
+
+		static const KernelTable table = kernels::x86::Supported()
+			? KernelTable{kernels::x86::AddN, kernels::x86::SubN, kernels::x86::Mul1, kernels::x86::AddMul1, "x86-64 adx/bmi2"}
+			: KernelTable{kernels::portable::AddN, kernels::portable::SubN, kernels::portable::Mul1, kernels::portable::AddMul1, "portable"};
+
+		return table;
+	}
+
+	// 10^19 is the largest power of ten which fits into a limb.
+	constexpr std::size_t kDigitsPerGroup = 19;
+	constexpr Limb kGroupBase = 10000000000000000000ull;
+
+	/**
+	 * Base10Powers - 10^(19 * 2^k) for k = 0, 1, ... while the power has at most half the limbs of _limbs
+	 * (at least the first one).
+	 */
+	std::vector<Limbs> Base10Powers(std::size_t _limbs)
+	{
+		std::vector<Limbs> powers{Limbs{kGroupBase}};
+		while(powers.back().size() * 4 <= _limbs)
+		{
+			powers.push_back(sav::kernels::Square(powers.back()));
+		}
+
+		return powers;
+	}
+
+	// Schoolbook conversion, 19 characters per limb multiplication.
+	Limbs FromBase10Basecase(const char* _digits, std::size_t _count)
+	{
+		Limbs result;
+		result.reserve(_count / kDigitsPerGroup + 1);
+
+		// The leading group takes the remainder, so that all following groups are full.
+		std::size_t width = _count % kDigitsPerGroup == 0 ? kDigitsPerGroup : _count % kDigitsPerGroup;
+		for(std::size_t position = 0; position < _count; position += width, width = kDigitsPerGroup)
+		{
+			Limb group = 0;
+			Limb scale = 1;
+			for(std::size_t i = 0; i < width; i++)
+			{
+				group = group * 10 + static_cast<Limb>(_digits[position + i] - '0');
+				scale *= 10;
+			}
+
+			// result = result * 10^width + group
+			Limb carry = sav::kernels::Mul1(result.data(), result.data(), result.size(), scale);
+			for(std::size_t i = 0; i < result.size() && group != 0; i++)
+			{
+				result[i] += group;
+				group = result[i] < group;
+			}
+
+			carry += group;
+			if(carry != 0)
+			{
+				result.push_back(carry);
+			}
+		}
+
+		sav::kernels::Trim(result);
+
+		return result;
+	}
+
+	// Divide and conquer: high * 10^(19 * 2^k) + low, the low part taking the largest power below half of the digits.
+	Limbs FromBase10Recursive(const char* _digits, std::size_t _count, const std::vector<Limbs>& _powers)
+	{
+		if(_count <= sav::kernels::Base10Threshold() * kDigitsPerGroup)
+		{
+			return FromBase10Basecase(_digits, _count);
+		}
+
+		std::size_t k = 0;
+		while(k + 1 < _powers.size() && (kDigitsPerGroup << (k + 1)) * 2 <= _count)
+		{
+			k++;
+		}
+
+		std::size_t lowCount = kDigitsPerGroup << k;
+		Limbs result = sav::kernels::Multiply(FromBase10Recursive(_digits, _count - lowCount, _powers), _powers[k]);
+		AddInPlace(result, FromBase10Recursive(_digits + _count - lowCount, lowCount, _powers));
+		sav::kernels::Trim(result);
+
+		return result;
+	}
+
+	// Divide and conquer: split by the largest power with at most half the limbs, convert both halves.
+	// Halves at or below the threshold are converted in place, they are temporaries of this call.
+	void ToBase10Recursive(const Limbs& _value, char* _last, std::size_t _width, const std::vector<Limbs>& _powers)
+	{
+		std::size_t k = _powers.size() - 1;
+		while(k > 0 && _powers[k].size() * 2 > _value.size())
+		{
+			k--;
+		}
+
+		Limbs quotient;
+		Limbs remainder;
+		sav::kernels::DivRem(_value, _powers[k], quotient, remainder);
+
+		auto convert = [&_powers](Limbs& _half, char* _halfLast, std::size_t _halfWidth)
+		{
+			if(_half.size() <= sav::kernels::Base10Threshold())
+			{
+				sav::kernels::ToBase10Basecase(_half.data(), _half.size(), _halfLast, _halfWidth);
+			}
+			else
+			{
+				ToBase10Recursive(_half, _halfLast, _halfWidth, _powers);
+			}
+		};
+
+		std::size_t lowWidth = kDigitsPerGroup << k;
+		convert(remainder, _last, lowWidth);
+		convert(quotient, _last - lowWidth, _width - lowWidth);
+	}
+}
+
+sav::kernels::Limbs sav::kernels::ToLimbs(const std::vector<std::uint8_t>& _digits)
+{
+	return ToLimbs(_digits.data(), _digits.size());
+}
+
+sav::kernels::Limbs sav::kernels::ToLimbs(const std::uint8_t* _digits, std::size_t _count, std::size_t _zeroLimbs)
+{
+	Limbs result(_zeroLimbs + (_count + kDigitsPerLimb - 1) / kDigitsPerLimb, 0);
+	Limb* limbs = result.data() + _zeroLimbs;
+
+	// 0x01 0x02 ... 0x08 0x09 -> 0x0807060504030201 0x09 (little-endian)
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		limbs[i / kDigitsPerLimb] |= static_cast<Limb>(_digits[i]) << (std::numeric_limits<std::uint8_t>::digits * (i % kDigitsPerLimb));
+	}
+
+	Trim(result);
+
+	return result;
+}
+
+std::vector<std::uint8_t> sav::kernels::ToDigits(const Limbs& _limbs)
+{
+	return ToDigits(_limbs.data(), _limbs.size());
+}
+
+std::vector<std::uint8_t> sav::kernels::ToDigits(const Limb* _limbs, std::size_t _count)
+{
+	std::vector<std::uint8_t> result;
+	result.reserve(_count * kDigitsPerLimb);
+
+	for(std::size_t limb = 0; limb < _count; limb++)
+	{
+		for(std::size_t i = 0; i < kDigitsPerLimb; i++)
+		{
+			result.push_back(static_cast<std::uint8_t>(_limbs[limb] >> (std::numeric_limits<std::uint8_t>::digits * i)));
+		}
+	}
+
+	while(!result.empty() && result.back() == 0x00)
+	{
+		result.pop_back();
+	}
+
+	if(result.empty())
+	{
+		result.push_back(0x00);
+	}
+
+	return result;
+}
+
+sav::kernels::Limbs sav::kernels::FromBase10(const char* _digits, std::size_t _count)
+{
+	if(_count <= Base10Threshold() * kDigitsPerGroup)
+	{
+		return FromBase10Basecase(_digits, _count);
+	}
+
+	return FromBase10Recursive(_digits, _count, Base10Powers(_count / kDigitsPerGroup + 1));
+}
+
+std::size_t sav::kernels::Base10Length(const Limbs& _value)
+{
+	std::size_t bits = BitLength(_value);
+	if(bits <= kLimbBits)
+	{
+		std::size_t length = 1;
+		for(Limb value = bits == 0 ? 0 : _value[0]; value >= 10; value /= 10)
+		{
+			length++;
+		}
+
+		return length;
+	}
+
+	// Length of 2^(bits - 1) <= value < 2^bits, exact or one off (either way, floating point included).
+	std::size_t length = Base10LengthBound(bits - 1) - 1;
+	Limbs lower = Power(Limbs{10}, length - 1);
+	if(Compare(_value, lower) < 0)
+	{
+		return length - 1;
+	}
+
+	Limbs upper(lower.size() + 1, 0);
+	upper[lower.size()] = Mul1(upper.data(), lower.data(), lower.size(), 10);
+
+	return Compare(_value, upper) < 0 ? length : length + 1;
+}
+
+std::size_t sav::kernels::Base10LengthBound(std::size_t _bits)
+{
+	// log10(2), the bound is floor(bits * log10(2)) + 1 digits, plus one against rounding
+	return static_cast<std::size_t>(static_cast<double>(_bits) * 0.30102999566398120) + 2;
+}
+
+void sav::kernels::ToBase10(const Limbs& _value, char* _last, std::size_t _width)
+{
+	if(_value.size() <= Base10Threshold())
+	{
+		Limbs value = _value;
+		ToBase10Basecase(value.data(), value.size(), _last, _width);
+		return;
+	}
+
+	ToBase10Recursive(_value, _last, _width, Base10Powers(_value.size()));
+}
+
+void sav::kernels::ToBase10Basecase(Limb* _value, std::size_t _count, char* _last, std::size_t _width)
+{
+	char* first = _last - _width;
+	char* cursor = _last;
+
+	// Repeated division by 10^19, a group of characters per division.
+	_count = EffectiveSize(_value, _count);
+	while(_count != 0 && cursor != first)
+	{
+		Limb group = DivRem1(_value, _value, _count, kGroupBase);
+		_count = EffectiveSize(_value, _count);
+
+		for(std::size_t i = 0; i < kDigitsPerGroup && cursor != first; i++)
+		{
+			*--cursor = static_cast<char>('0' + group % 10);
+			group /= 10;
+		}
+	}
+
+	std::fill(first, cursor, '0');
+}
+
+void sav::kernels::Trim(Limbs& _limbs)
+{
+	_limbs.resize(EffectiveSize(_limbs.data(), _limbs.size()));
+}
+
+int sav::kernels::Compare(const Limbs& _lhs, const Limbs& _rhs)
+{
+	std::size_t lhsCount = EffectiveSize(_lhs.data(), _lhs.size());
+	std::size_t rhsCount = EffectiveSize(_rhs.data(), _rhs.size());
+
+	if(lhsCount != rhsCount)
+	{
+		return lhsCount < rhsCount ? -1 : 1;
+	}
+
+	return CompareN(_lhs.data(), _rhs.data(), lhsCount);
+}
+
+int sav::kernels::CompareDoubled(const Limbs& _lhs, const Limbs& _rhs)
+{
+	const std::size_t lhsCount = EffectiveSize(_lhs.data(), _lhs.size());
+	const std::size_t rhsCount = EffectiveSize(_rhs.data(), _rhs.size());
+
+	// Limb i of 2 * _lhs takes the top bit of limb i - 1.
+	auto doubled = [&](std::size_t _index) -> Limb
+	{
+		Limb high = _index < lhsCount ? _lhs[_index] << 1 : 0;
+		Limb low = _index != 0 && _index - 1 < lhsCount ? _lhs[_index - 1] >> (kLimbBits - 1) : 0;
+		return high | low;
+	};
+
+	for(std::size_t i = std::max(lhsCount + 1, rhsCount); i-- > 0;)
+	{
+		Limb lhs = doubled(i);
+		Limb rhs = i < rhsCount ? _rhs[i] : 0;
+
+		if(lhs != rhs)
+		{
+			return lhs < rhs ? -1 : 1;
+		}
+	}
+
+	return 0;
+}
+
+void sav::kernels::Increment(Limbs& _limbs)
+{
+	for(auto& limb : _limbs)
+	{
+		if(++limb != 0)
+		{
+			return;
+		}
+	}
+
+	_limbs.push_back(1);
+}
+
+std::size_t sav::kernels::BitLength(const Limbs& _limbs)
+{
+	return BitLength(_limbs.data(), _limbs.size());
+}
+
+std::size_t sav::kernels::BitLength(const Limb* _limbs, std::size_t _count)
+{
+	std::size_t count = EffectiveSize(_limbs, _count);
+	if(count == 0)
+	{
+		return 0;
+	}
+
+	return count * kLimbBits - CountLeadingZeros(_limbs[count - 1]);
+}
+
+sav::kernels::Limb sav::kernels::MulWide(Limb _lhs, Limb _rhs, Limb& _high)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 product = static_cast<unsigned __int128>(_lhs) * _rhs;
+	_high = static_cast<Limb>(product >> kLimbBits);
+	return static_cast<Limb>(product);
+#else
+	constexpr Limb kHalfMask = 0xFFFF'FFFF;
+	constexpr unsigned int kHalfBits = kLimbBits / 2;
+
+	Limb lowLow = (_lhs & kHalfMask) * (_rhs & kHalfMask);
+	Limb lowHigh = (_lhs & kHalfMask) * (_rhs >> kHalfBits);
+	Limb highLow = (_lhs >> kHalfBits) * (_rhs & kHalfMask);
+	Limb highHigh = (_lhs >> kHalfBits) * (_rhs >> kHalfBits);
+
+	Limb middle = (lowLow >> kHalfBits) + (lowHigh & kHalfMask) + (highLow & kHalfMask);
+	_high = highHigh + (lowHigh >> kHalfBits) + (highLow >> kHalfBits) + (middle >> kHalfBits);
+	return (middle << kHalfBits) | (lowLow & kHalfMask);
+#endif
+}
+
+sav::kernels::Limb sav::kernels::DivWide(Limb _high, Limb _low, Limb _divisor, Limb& _remainder)
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 dividend = (static_cast<unsigned __int128>(_high) << kLimbBits) | _low;
+	_remainder = static_cast<Limb>(dividend % _divisor);
+	return static_cast<Limb>(dividend / _divisor);
+#else
+	// Two steps of schoolbook division in base 2^32 (Hacker's Delight, divlu).
+	constexpr Limb kHalfBase = Limb{1} << (kLimbBits / 2);
+	constexpr Limb kHalfMask = kHalfBase - 1;
+	constexpr unsigned int kHalfBits = kLimbBits / 2;
+
+	unsigned int shift = CountLeadingZeros(_divisor);
+	_divisor <<= shift;
+	_high = (_high << shift) | (shift != 0 ? _low >> (kLimbBits - shift) : 0);
+	_low <<= shift;
+
+	Limb divisorHigh = _divisor >> kHalfBits;
+	Limb divisorLow = _divisor & kHalfMask;
+	Limb lowHigh = _low >> kHalfBits;
+	Limb lowLow = _low & kHalfMask;
+
+	Limb quotientHigh = _high / divisorHigh;
+	Limb estimateRemainder = _high - quotientHigh * divisorHigh;
+	while(quotientHigh >= kHalfBase || quotientHigh * divisorLow > ((estimateRemainder << kHalfBits) | lowHigh))
+	{
+		quotientHigh--;
+		estimateRemainder += divisorHigh;
+		if(estimateRemainder >= kHalfBase)
+		{
+			break;
+		}
+	}
+
+	Limb partial = (_high << kHalfBits) + lowHigh - quotientHigh * _divisor;
+
+	Limb quotientLow = partial / divisorHigh;
+	estimateRemainder = partial - quotientLow * divisorHigh;
+	while(quotientLow >= kHalfBase || quotientLow * divisorLow > ((estimateRemainder << kHalfBits) | lowLow))
+	{
+		quotientLow--;
+		estimateRemainder += divisorHigh;
+		if(estimateRemainder >= kHalfBase)
+		{
+			break;
+		}
+	}
+
+	_remainder = ((partial << kHalfBits) + lowLow - quotientLow * _divisor) >> shift;
+	return (quotientHigh << kHalfBits) | quotientLow;
+#endif
+}
+
+sav::kernels::Limb sav::kernels::AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	return Kernels().m_addN(_result, _lhs, _rhs, _count);
+}
+
+sav::kernels::Limb sav::kernels::SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	return Kernels().m_subN(_result, _lhs, _rhs, _count);
+}
+
+sav::kernels::Limb sav::kernels::Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	return Kernels().m_mul1(_result, _lhs, _count, _rhs);
+}
+
+sav::kernels::Limb sav::kernels::AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	return Kernels().m_addMul1(_result, _lhs, _count, _rhs);
+}
+
+const char* sav::kernels::KernelsName()
+{
+	return Kernels().m_name;
+}
+
+sav::kernels::Limb sav::kernels::portable::AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	Limb carry = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb sum = _lhs[i] + carry;
+		carry = sum < carry;
+		sum += _rhs[i];
+		carry += sum < _rhs[i];
+		_result[i] = sum;
+	}
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::portable::SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	Limb borrow = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb subtrahend = _rhs[i] + borrow;
+		borrow = subtrahend < borrow;
+		Limb limb = _lhs[i];
+		borrow += limb < subtrahend;
+		_result[i] = limb - subtrahend;
+	}
+
+	return borrow;
+}
+
+sav::kernels::Limb sav::kernels::Add(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount)
+{
+	Limb carry = AddN(_result, _lhs, _rhs, _rhsCount);
+	for(std::size_t i = _rhsCount; i < _lhsCount; i++)
+	{
+		_result[i] = _lhs[i] + carry;
+		carry = _result[i] < carry;
+	}
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::Sub(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount)
+{
+	Limb borrow = SubN(_result, _lhs, _rhs, _rhsCount);
+	for(std::size_t i = _rhsCount; i < _lhsCount; i++)
+	{
+		Limb limb = _lhs[i];
+		_result[i] = limb - borrow;
+		borrow = limb < borrow;
+	}
+
+	return borrow;
+}
+
+sav::kernels::Limb sav::kernels::portable::Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	Limb carry = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb high = 0;
+		Limb low = MulWide(_lhs[i], _rhs, high);
+		low += carry;
+		carry = high + (low < carry);
+		_result[i] = low;
+	}
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::portable::AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	Limb carry = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb high = 0;
+		Limb low = MulWide(_lhs[i], _rhs, high);
+		low += carry;
+		high += low < carry;
+		low += _result[i];
+		high += low < _result[i];
+		_result[i] = low;
+		carry = high;
+	}
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::SubMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	Limb borrow = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb high = 0;
+		Limb low = MulWide(_lhs[i], _rhs, high);
+		low += borrow;
+		high += low < borrow;
+		borrow = high + (_result[i] < low);
+		_result[i] -= low;
+	}
+
+	return borrow;
+}
+
+sav::kernels::Limb sav::kernels::LShift(Limb* _result, const Limb* _source, std::size_t _count, unsigned int _bits)
+{
+	if(_bits == 0)
+	{
+		std::copy(_source, _source + _count, _result);
+		return 0;
+	}
+
+	Limb out = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb limb = _source[i];
+		_result[i] = (limb << _bits) | out;
+		out = limb >> (kLimbBits - _bits);
+	}
+
+	return out;
+}
+
+sav::kernels::Limb sav::kernels::RShift(Limb* _result, const Limb* _source, std::size_t _count, unsigned int _bits)
+{
+	if(_bits == 0)
+	{
+		std::copy(_source, _source + _count, _result);
+		return 0;
+	}
+
+	Limb out = 0;
+	for(std::size_t i = _count; i-- > 0;)
+	{
+		Limb limb = _source[i];
+		_result[i] = (limb >> _bits) | out;
+		out = limb << (kLimbBits - _bits);
+	}
+
+	return out;
+}
+
+void sav::kernels::MulBasecase(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount)
+{
+	if(_lhsCount == 0 || _rhsCount == 0)
+	{
+		std::fill(_result, _result + _lhsCount + _rhsCount, 0);
+		return;
+	}
+
+	_result[_lhsCount] = Mul1(_result, _lhs, _lhsCount, _rhs[0]);
+
+	for(std::size_t i = 1; i < _rhsCount; i++)
+	{
+		_result[_lhsCount + i] = AddMul1(_result + i, _lhs, _lhsCount, _rhs[i]);
+	}
+}
+
+void sav::kernels::Mul(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount)
+{
+	if(_lhsCount < _rhsCount)
+	{
+		std::swap(_lhs, _rhs);
+		std::swap(_lhsCount, _rhsCount);
+	}
+
+	if(_rhsCount < KaratsubaThreshold())
+	{
+		MulBasecase(_result, _lhs, _lhsCount, _rhs, _rhsCount);
+		return;
+	}
+
+	const std::size_t resultCount = _lhsCount + _rhsCount;
+
+	// Unbalanced operands: multiply _rhs by _rhsCount-sized chunks of _lhs.
+	if(_lhsCount >= 2 * _rhsCount)
+	{
+		std::fill(_result, _result + resultCount, 0);
+
+		Limbs chunkProduct(2 * _rhsCount);
+		for(std::size_t offset = 0; offset < _lhsCount; offset += _rhsCount)
+		{
+			std::size_t chunkCount = std::min(_rhsCount, _lhsCount - offset);
+			Mul(chunkProduct.data(), _lhs + offset, chunkCount, _rhs, _rhsCount);
+			Add(_result + offset, _result + offset, resultCount - offset, chunkProduct.data(), chunkCount + _rhsCount);
+		}
+
+		return;
+	}
+
+	// Karatsuba: (a1 * B + a0) * (b1 * B + b0) =
+	// a1 * b1 * B^2 + ((a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1) * B + a0 * b0
+	const std::size_t k = _lhsCount / 2;
+	const std::size_t lhsHighCount = _lhsCount - k;
+	const std::size_t rhsHighCount = _rhsCount - k;
+
+	Mul(_result, _lhs, k, _rhs, k);
+	Mul(_result + 2 * k, _lhs + k, lhsHighCount, _rhs + k, rhsHighCount);
+
+	Limbs lhsSum(lhsHighCount + 1);
+	lhsSum[lhsHighCount] = Add(lhsSum.data(), _lhs + k, lhsHighCount, _lhs, k);
+
+	const std::size_t rhsSumCount = std::max(k, rhsHighCount);
+	Limbs rhsSum(rhsSumCount + 1);
+	if(rhsHighCount >= k)
+	{
+		rhsSum[rhsSumCount] = Add(rhsSum.data(), _rhs + k, rhsHighCount, _rhs, k);
+	}
+	else
+	{
+		rhsSum[rhsSumCount] = Add(rhsSum.data(), _rhs, k, _rhs + k, rhsHighCount);
+	}
+
+	Limbs middle(lhsSum.size() + rhsSum.size());
+	Mul(middle.data(), lhsSum.data(), lhsSum.size(), rhsSum.data(), rhsSum.size());
+	Sub(middle.data(), middle.data(), middle.size(), _result, 2 * k);
+	Sub(middle.data(), middle.data(), middle.size(), _result + 2 * k, lhsHighCount + rhsHighCount);
+	Trim(middle);
+
+	Add(_result + k, _result + k, resultCount - k, middle.data(), middle.size());
+}
+
+void sav::kernels::SqrBasecase(Limb* _result, const Limb* _source, std::size_t _count)
+{
+	std::fill(_result, _result + 2 * _count, 0);
+
+	// Every off-diagonal product a[i] * a[j] (i < j) once...
+	for(std::size_t i = 0; i + 1 < _count; i++)
+	{
+		_result[_count + i] = AddMul1(_result + 2 * i + 1, _source + i + 1, _count - i - 1, _source[i]);
+	}
+
+	// ...doubled, plus the diagonal a[i]^2
+	LShift(_result, _result, 2 * _count, 1);
+
+	Limb carry = 0;
+	for(std::size_t i = 0; i < _count; i++)
+	{
+		Limb high = 0;
+		Limb low = MulWide(_source[i], _source[i], high);
+
+		low += carry;
+		high += low < carry;
+		_result[2 * i] += low;
+		high += _result[2 * i] < low;
+
+		_result[2 * i + 1] += high;
+		carry = _result[2 * i + 1] < high;
+	}
+}
+
+void sav::kernels::Sqr(Limb* _result, const Limb* _source, std::size_t _count)
+{
+	if(_count < KaratsubaThreshold())
+	{
+		SqrBasecase(_result, _source, _count);
+		return;
+	}
+
+	// (a1 * B + a0)^2 = a1^2 * B^2 + (a1^2 + a0^2 - (a1 - a0)^2) * B + a0^2
+	const std::size_t k = _count / 2;
+	const std::size_t highCount = _count - k;
+
+	Sqr(_result, _source, k);
+	Sqr(_result + 2 * k, _source + k, highCount);
+
+	Limbs low{_source, _source + k};
+	Limbs high{_source + k, _source + _count};
+	low.resize(highCount, 0);
+	if(CompareN(high.data(), low.data(), highCount) < 0)
+	{
+		low.swap(high);
+	}
+
+	Limbs difference(highCount);
+	SubN(difference.data(), high.data(), low.data(), highCount);
+
+	Limbs differenceSquared(2 * highCount);
+	Sqr(differenceSquared.data(), difference.data(), highCount);
+
+	Limbs middle{_result + 2 * k, _result + 2 * _count};
+	middle.push_back(0);
+	Add(middle.data(), middle.data(), middle.size(), _result, 2 * k);
+	Sub(middle.data(), middle.data(), middle.size(), differenceSquared.data(), differenceSquared.size());
+	Trim(middle);
+
+	Add(_result + k, _result + k, 2 * _count - k, middle.data(), middle.size());
+}
+
+sav::kernels::Limb sav::kernels::DivRem1(Limb* _quotient, const Limb* _dividend, std::size_t _count, Limb _divisor)
+{
+	Limb remainder = 0;
+	for(std::size_t i = _count; i-- > 0;)
+	{
+		_quotient[i] = DivWide(remainder, _dividend[i], _divisor, remainder);
+	}
+
+	return remainder;
+}
+
+sav::kernels::Limb sav::kernels::InverseLimb(Limb _odd)
+{
+	// _odd * _odd == 1 (mod 8), then every Newton step doubles the count of correct bits: 3, 6, 12, 24, 48, 96.
+	Limb inverse = _odd;
+	for(int i = 0; i < 5; i++)
+	{
+		inverse *= 2 - _odd * inverse;
+	}
+
+	return inverse;
+}
+
+sav::kernels::Limbs sav::kernels::Multiply(const Limbs& _lhs, const Limbs& _rhs)
+{
+	if(_lhs.empty() || _rhs.empty())
+	{
+		return Limbs{};
+	}
+
+	Limbs result(_lhs.size() + _rhs.size());
+	Mul(result.data(), _lhs.data(), _lhs.size(), _rhs.data(), _rhs.size());
+	Trim(result);
+
+	return result;
+}
+
+sav::kernels::Limbs sav::kernels::Square(const Limbs& _value)
+{
+	if(_value.empty())
+	{
+		return Limbs{};
+	}
+
+	Limbs result(2 * _value.size());
+	Sqr(result.data(), _value.data(), _value.size());
+	Trim(result);
+
+	return result;
+}
+
+sav::kernels::Limbs sav::kernels::Power(const Limbs& _base, std::uint64_t _exponent)
+{
+	if(_exponent == 0)
+	{
+		return Limbs{1};
+	}
+
+	unsigned int bit = kLimbBits - 1 - CountLeadingZeros(_exponent);
+
+	Limbs result = _base;
+	while(bit-- > 0)
+	{
+		result = Square(result);
+		if((_exponent >> bit) & 1)
+		{
+			result = Multiply(result, _base);
+		}
+	}
+
+	return result;
+}
+
+void sav::kernels::DivRem(const Limbs& _dividend, const Limbs& _divisor, Limbs& _quotient, Limbs& _remainder)
+{
+	if(Compare(_dividend, _divisor) < 0)
+	{
+		_quotient.clear();
+		_remainder = _dividend;
+		Trim(_remainder);
+		return;
+	}
+
+	if(_divisor.size() == 1)
+	{
+		_quotient.resize(_dividend.size());
+		_remainder = Limbs{DivRem1(_quotient.data(), _dividend.data(), _dividend.size(), _divisor[0])};
+		Trim(_quotient);
+		Trim(_remainder);
+		return;
+	}
+
+	// Normalize, so that the most significant bit of the divisor is set (the quotient stays the same).
+	const std::size_t n = _divisor.size();
+	const unsigned int shift = CountLeadingZeros(_divisor.back());
+
+	Limbs divisor(n);
+	LShift(divisor.data(), _divisor.data(), n, shift);
+
+	Limbs dividend(_dividend.size() + 1);
+	dividend.back() = LShift(dividend.data(), _dividend.data(), _dividend.size(), shift);
+
+	if(n < BurnikelZieglerThreshold() || dividend.size() - n < BurnikelZieglerThreshold())
+	{
+		_quotient.assign(dividend.size() - n + 1, 0);
+		KnuthDivRem(_quotient.data(), dividend.data(), dividend.size(), divisor.data(), n);
+		dividend.resize(n);
+	}
+	else
+	{
+		// Schoolbook division in base B^n, every step divides 2n limbs by n limbs recursively.
+		const std::size_t blocks = (dividend.size() + n - 1) / n;
+		dividend.resize(blocks * n, 0);
+		_quotient.assign(blocks * n, 0);
+
+		Limbs remainder(n, 0);
+		for(std::size_t i = blocks; i-- > 0;)
+		{
+			Limbs blockQuotient;
+			Limbs blockRemainder;
+			RecursiveDivRem(Concatenated(dividend.data() + i * n, n, remainder), divisor, blockQuotient, blockRemainder);
+
+			std::copy(blockQuotient.begin(), blockQuotient.end(), _quotient.begin() + i * n);
+			remainder = blockRemainder;
+			remainder.resize(n, 0);
+		}
+
+		dividend = remainder;
+	}
+
+	_remainder.resize(n);
+	RShift(_remainder.data(), dividend.data(), n, shift);
+	Trim(_quotient);
+	Trim(_remainder);
+}
+
+sav::kernels::Limbs sav::kernels::DivExact(const Limbs& _dividend, const Limbs& _divisor)
+{
+	if(Compare(_dividend, _divisor) < 0)
+	{
+		return Limbs{};
+	}
+
+	// Strip the common power of two, so that the divisor becomes odd (invertible modulo 2^64).
+	std::size_t zeroLimbs = 0;
+	while(_divisor[zeroLimbs] == 0)
+	{
+		zeroLimbs++;
+	}
+
+	unsigned int zeroBits = 0;
+	while(((_divisor[zeroLimbs] >> zeroBits) & 1) == 0)
+	{
+		zeroBits++;
+	}
+
+	const std::size_t divisorCount = _divisor.size() - zeroLimbs;
+	Limbs divisor(divisorCount);
+	RShift(divisor.data(), _divisor.data() + zeroLimbs, divisorCount, zeroBits);
+	Trim(divisor);
+
+	Limbs remainder(_dividend.size() - zeroLimbs);
+	RShift(remainder.data(), _dividend.data() + zeroLimbs, remainder.size(), zeroBits);
+	Trim(remainder);
+
+	if(remainder.size() < divisor.size())
+	{
+		return Limbs{};
+	}
+
+	// The quotient is below base^quotientCount, so it equals dividend / divisor (mod base^quotientCount)
+	// and only the low quotientCount limbs of the dividend ever have to be updated.
+	const std::size_t quotientCount = remainder.size() - divisor.size() + 1;
+	const Limb inverse = InverseLimb(divisor[0]);
+
+	Limbs quotient(quotientCount);
+	for(std::size_t i = 0; i < quotientCount; i++)
+	{
+		// Choose the quotient limb which zeroes the lowest remaining limb
+		quotient[i] = remainder[i] * inverse;
+
+		std::size_t count = std::min(divisor.size(), quotientCount - i);
+		Limb borrow = SubMul1(remainder.data() + i, divisor.data(), count, quotient[i]);
+		if(i + count < quotientCount)
+		{
+			Sub(remainder.data() + i + count, remainder.data() + i + count, quotientCount - i - count, &borrow, 1);
+		}
+	}
+
+	Trim(quotient);
+
+	return quotient;
+}
+
+sav::kernels::Limbs sav::kernels::Gcd(Limbs _lhs, Limbs _rhs)
+{
+	Trim(_lhs);
+	Trim(_rhs);
+
+	if(Compare(_lhs, _rhs) < 0)
+	{
+		std::swap(_lhs, _rhs);
+	}
+
+	while(_rhs.size() > 1)
+	{
+		auto matrix = SimulateLehmer(_lhs, _rhs);
+
+		// The leading bits did not determine even one quotient: take a full division step
+		if(matrix.Steps == 0)
+		{
+			Limbs quotient;
+			Limbs remainder;
+			DivRem(_lhs, _rhs, quotient, remainder);
+			_lhs.swap(_rhs);
+			_rhs.swap(remainder);
+			continue;
+		}
+
+		auto lhs = Combine(_lhs, _rhs, matrix.A, matrix.B);
+		_rhs = Combine(_lhs, _rhs, matrix.C, matrix.D);
+		_lhs.swap(lhs);
+	}
+
+	if(_rhs.empty())
+	{
+		return _lhs;
+	}
+
+	// Single limb left: one reduction, then binary GCD
+	Limbs quotient(_lhs.size());
+	Limb remainder = DivRem1(quotient.data(), _lhs.data(), _lhs.size(), _rhs[0]);
+
+	Limbs result{BinaryGcd(_rhs[0], remainder)};
+	return result;
+}
+
+sav::kernels::Limbs sav::kernels::ExtendedGcd(Limbs _lhs, Limbs _rhs, Limbs& _cofactor, bool& _cofactorNegative)
+{
+	Trim(_lhs);
+	Trim(_rhs);
+
+	// Cofactors of _lhs for the current pair, their signs alternate with every Euclid step,
+	// so only magnitudes and the parity of the step count are kept.
+	Limbs lhsCofactor{1};
+	Limbs rhsCofactor;
+	std::size_t steps = 0;
+
+	while(!_rhs.empty())
+	{
+		if(_rhs.size() > 1 && Compare(_lhs, _rhs) >= 0)
+		{
+			auto matrix = SimulateLehmer(_lhs, _rhs);
+			if(matrix.Steps != 0)
+			{
+				auto lhs = Combine(_lhs, _rhs, matrix.A, matrix.B);
+				_rhs = Combine(_lhs, _rhs, matrix.C, matrix.D);
+				_lhs.swap(lhs);
+
+				auto cofactor = Combine(lhsCofactor, rhsCofactor, Magnitude(matrix.A), Magnitude(matrix.B));
+				rhsCofactor = Combine(lhsCofactor, rhsCofactor, Magnitude(matrix.C), Magnitude(matrix.D));
+				lhsCofactor.swap(cofactor);
+
+				steps += matrix.Steps;
+				continue;
+			}
+		}
+
+		// Full Euclid step: (a, b) -> (b, a mod b), (s, t) -> (t, s + q * t)
+		Limbs quotient;
+		Limbs remainder;
+		DivRem(_lhs, _rhs, quotient, remainder);
+		_lhs.swap(_rhs);
+		_rhs.swap(remainder);
+
+		auto cofactor = Multiply(quotient, rhsCofactor);
+		AddInPlace(cofactor, lhsCofactor);
+		Trim(cofactor);
+		lhsCofactor.swap(rhsCofactor);
+		rhsCofactor.swap(cofactor);
+		steps++;
+	}
+
+	_cofactor = lhsCofactor;
+	_cofactorNegative = (steps % 2) != 0;
+
+	return _lhs;
+}
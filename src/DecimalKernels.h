@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef DECIMAL_VLN_BCD_DECIMALKERNELS_H
+#define DECIMAL_VLN_BCD_DECIMALKERNELS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace sav
+{
+	/**
+	 * Internal limb kernels.
+	 * Decimal stores base256 digits; heavy algorithms repack them into 64-bit limbs
+	 * (little-endian, same numeric value) and run on those.
+	 * Raw pointer kernels follow the "result, operands, sizes" convention and return the carry/borrow limb.
+	 */
+	namespace kernels
+	{
+		using Limb = std::uint64_t;
+		using Limbs = std::vector<Limb>;
+
+		enum : std::size_t
+		{
+			kLimbBits = 64,
+			kDigitsPerLimb = sizeof(Limb)
+		};
+
+		// Operand sizes (in limbs) from which the subquadratic algorithms take over, see DecimalThresholds.
+		std::size_t KaratsubaThreshold();
+		std::size_t BurnikelZieglerThreshold();
+		std::size_t Base10Threshold();
+
+		// Conversions from/to base256 digits. Limbs are trimmed, digits are normalized (at least one digit).
+		// _zeroLimbs zero limbs are put below the converted digits (none if they are all zero).
+		Limbs ToLimbs(const std::vector<std::uint8_t>& _digits);
+		Limbs ToLimbs(const std::uint8_t* _digits, std::size_t _count, std::size_t _zeroLimbs = 0);
+		std::vector<std::uint8_t> ToDigits(const Limbs& _limbs);
+		std::vector<std::uint8_t> ToDigits(const Limb* _limbs, std::size_t _count);
+
+		// Conversion from base10 characters, which must all be '0'..'9'.
+		Limbs FromBase10(const char* _digits, std::size_t _count);
+
+		/**
+		 * ToBase10 - write exactly _width base10 characters ending at _last, zero-padded on the left.
+		 * @param _value must be less than 10^_width
+		 */
+		void ToBase10(const Limbs& _value, char* _last, std::size_t _width);
+
+		// Same as ToBase10 by repeated division (no divide and conquer), in place: _value is destroyed, nothing is allocated.
+		void ToBase10Basecase(Limb* _value, std::size_t _count, char* _last, std::size_t _width);
+
+		// Exact count of base10 digits (1 for zero).
+		std::size_t Base10Length(const Limbs& _value);
+
+		// Upper bound of the count of base10 digits of a value with _bits significant bits.
+		std::size_t Base10LengthBound(std::size_t _bits);
+
+		// Remove most significant zero limbs.
+		void Trim(Limbs& _limbs);
+
+		// -1, 0, 1 (most significant zero limbs are ignored).
+		int Compare(const Limbs& _lhs, const Limbs& _rhs);
+
+		// Sign of 2 * _lhs - _rhs in a single pass, without computing the double (-1, 0, 1).
+		int CompareDoubled(const Limbs& _lhs, const Limbs& _rhs);
+
+		// _limbs += 1, growing by a limb on carry-out.
+		void Increment(Limbs& _limbs);
+
+		// Count of significant bits.
+		std::size_t BitLength(const Limbs& _limbs);
+		std::size_t BitLength(const Limb* _limbs, std::size_t _count);
+
+		// Full 64x64 -> 128 multiplication, returns the low limb.
+		Limb MulWide(Limb _lhs, Limb _rhs, Limb& _high);
+
+		// 128 / 64 division, requires _high < _divisor.
+		Limb DivWide(Limb _high, Limb _low, Limb _divisor, Limb& _remainder);
+
+		// AddN, SubN, Mul1 and AddMul1 dispatch to the x86-64 kernels if the CPU has ADX and BMI2, to the portable ones otherwise.
+		Limb AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+		Limb SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+
+		// _lhsCount >= _rhsCount, _result has _lhsCount limbs.
+		Limb Add(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount);
+		Limb Sub(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount);
+
+		// _result = _lhs * _rhs, _result += _lhs * _rhs, _result -= _lhs * _rhs.
+		Limb Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+		Limb AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+		Limb SubMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+
+		// Name of the selected AddN/SubN/Mul1/AddMul1 implementation.
+		const char* KernelsName();
+
+		// Implementations in plain C++, available everywhere.
+		namespace portable
+		{
+			Limb AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+			Limb SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+			Limb Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+			Limb AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+		}
+
+		// x86-64 implementations (mulx, adcx/adox), valid only if Supported(); forward to portable elsewhere.
+		namespace x86
+		{
+			bool Supported();
+
+			Limb AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+			Limb SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count);
+			Limb Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+			Limb AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs);
+		}
+
+		// Bit shifts by 0 <= _bits < kLimbBits, return the bits shifted out.
+		Limb LShift(Limb* _result, const Limb* _source, std::size_t _count, unsigned int _bits);
+		Limb RShift(Limb* _result, const Limb* _source, std::size_t _count, unsigned int _bits);
+
+		// _result has _lhsCount + _rhsCount limbs and must not overlap the operands.
+		void MulBasecase(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount);
+		void Mul(Limb* _result, const Limb* _lhs, std::size_t _lhsCount, const Limb* _rhs, std::size_t _rhsCount);
+
+		// _result has 2 * _count limbs and must not overlap the operand.
+		void SqrBasecase(Limb* _result, const Limb* _source, std::size_t _count);
+		void Sqr(Limb* _result, const Limb* _source, std::size_t _count);
+
+		// Single limb divisor, returns the remainder. _quotient has _count limbs.
+		Limb DivRem1(Limb* _quotient, const Limb* _dividend, std::size_t _count, Limb _divisor);
+
+		// Inverse of an odd limb modulo 2^64.
+		Limb InverseLimb(Limb _odd);
+
+		// Vector-level operations on trimmed operands.
+		Limbs Multiply(const Limbs& _lhs, const Limbs& _rhs);
+		Limbs Square(const Limbs& _value);
+
+		// Left-to-right binary exponentiation.
+		Limbs Power(const Limbs& _base, std::uint64_t _exponent);
+
+		/**
+		 * DivRem - integer division of trimmed operands.
+		 * Knuth's algorithm D, switching to Burnikel-Ziegler recursive division for large operands.
+		 * @param _divisor must not be zero
+		 */
+		void DivRem(const Limbs& _dividend, const Limbs& _divisor, Limbs& _quotient, Limbs& _remainder);
+
+		/**
+		 * DivExact - Jebelean's exact division (Hensel division from the least significant end).
+		 * @param _divisor must not be zero and must divide _dividend, otherwise the quotient is meaningless
+		 */
+		Limbs DivExact(const Limbs& _dividend, const Limbs& _divisor);
+
+		/**
+		 * Gcd - greatest common divisor.
+		 * Lehmer's algorithm while the operands are multi-limb, binary GCD once they fit into a single limb.
+		 */
+		Limbs Gcd(Limbs _lhs, Limbs _rhs);
+
+		/**
+		 * ExtendedGcd - greatest common divisor and the cofactor X of _lhs, i.e. _lhs * X == gcd (mod _rhs).
+		 * @param _cofactor |X|
+		 * @param _cofactorNegative sign of X
+		 */
+		Limbs ExtendedGcd(Limbs _lhs, Limbs _rhs, Limbs& _cofactor, bool& _cofactorNegative);
+	}
+}
+
+#endif //DECIMAL_VLN_BCD_DECIMALKERNELS_H
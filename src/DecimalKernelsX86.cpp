@@ -0,0 +1,282 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalKernels.h"
+
+/**
+ * x86-64 carry-chain kernels.
+ * mulx (BMI2) multiplies without touching the flags and adcx/adox (ADX) run two independent carry chains
+ * through CF and OF, so the low and high halves of the products are added in the same pass.
+ * Loops count with lea/jrcxz, which leave the flags alone.
+ */
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#include <cpuid.h>
+
+bool sav::kernels::x86::Supported()
+{
+	unsigned int eax = 0;
+	unsigned int ebx = 0;
+	unsigned int ecx = 0;
+	unsigned int edx = 0;
+
+	if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+	{
+		return false;
+	}
+
+	// Structured extended features : EBX bit 8 BMI2, bit 19 ADX
+	constexpr unsigned int kBmi2 = 1u << 8;
+	constexpr unsigned int kAdx = 1u << 19;
+
+	return (ebx & kBmi2) != 0 && (ebx & kAdx) != 0;
+}
+
+sav::kernels::Limb sav::kernels::x86::AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	std::size_t blocks = _count / 4;
+	std::size_t rest = _count % 4;
+	Limb carry = 0;
+	Limb t0;
+	Limb t1;
+	Limb t2;
+	Limb t3;
+
+	__asm__ volatile(
+		"clc\n\t"
+		"1:\n\t"
+		"jrcxz 2f\n\t"
+		"movq (%[lhs]), %[t0]\n\t"
+		"movq 8(%[lhs]), %[t1]\n\t"
+		"movq 16(%[lhs]), %[t2]\n\t"
+		"movq 24(%[lhs]), %[t3]\n\t"
+		"adcq (%[rhs]), %[t0]\n\t"
+		"adcq 8(%[rhs]), %[t1]\n\t"
+		"adcq 16(%[rhs]), %[t2]\n\t"
+		"adcq 24(%[rhs]), %[t3]\n\t"
+		"movq %[t0], (%[result])\n\t"
+		"movq %[t1], 8(%[result])\n\t"
+		"movq %[t2], 16(%[result])\n\t"
+		"movq %[t3], 24(%[result])\n\t"
+		"leaq 32(%[lhs]), %[lhs]\n\t"
+		"leaq 32(%[rhs]), %[rhs]\n\t"
+		"leaq 32(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"movq %[rest], %%rcx\n\t"
+		"3:\n\t"
+		"jrcxz 4f\n\t"
+		"movq (%[lhs]), %[t0]\n\t"
+		"adcq (%[rhs]), %[t0]\n\t"
+		"movq %[t0], (%[result])\n\t"
+		"leaq 8(%[lhs]), %[lhs]\n\t"
+		"leaq 8(%[rhs]), %[rhs]\n\t"
+		"leaq 8(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 3b\n\t"
+		"4:\n\t"
+		"adcq $0, %[carry]\n\t"
+		: [result] "+r"(_result), [lhs] "+r"(_lhs), [rhs] "+r"(_rhs), "+c"(blocks), [carry] "+r"(carry),
+			[t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3)
+		: [rest] "r"(rest)
+		: "cc", "memory");
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::x86::SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	std::size_t blocks = _count / 4;
+	std::size_t rest = _count % 4;
+	Limb borrow = 0;
+	Limb t0;
+	Limb t1;
+	Limb t2;
+	Limb t3;
+
+	__asm__ volatile(
+		"clc\n\t"
+		"1:\n\t"
+		"jrcxz 2f\n\t"
+		"movq (%[lhs]), %[t0]\n\t"
+		"movq 8(%[lhs]), %[t1]\n\t"
+		"movq 16(%[lhs]), %[t2]\n\t"
+		"movq 24(%[lhs]), %[t3]\n\t"
+		"sbbq (%[rhs]), %[t0]\n\t"
+		"sbbq 8(%[rhs]), %[t1]\n\t"
+		"sbbq 16(%[rhs]), %[t2]\n\t"
+		"sbbq 24(%[rhs]), %[t3]\n\t"
+		"movq %[t0], (%[result])\n\t"
+		"movq %[t1], 8(%[result])\n\t"
+		"movq %[t2], 16(%[result])\n\t"
+		"movq %[t3], 24(%[result])\n\t"
+		"leaq 32(%[lhs]), %[lhs]\n\t"
+		"leaq 32(%[rhs]), %[rhs]\n\t"
+		"leaq 32(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"movq %[rest], %%rcx\n\t"
+		"3:\n\t"
+		"jrcxz 4f\n\t"
+		"movq (%[lhs]), %[t0]\n\t"
+		"sbbq (%[rhs]), %[t0]\n\t"
+		"movq %[t0], (%[result])\n\t"
+		"leaq 8(%[lhs]), %[lhs]\n\t"
+		"leaq 8(%[rhs]), %[rhs]\n\t"
+		"leaq 8(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 3b\n\t"
+		"4:\n\t"
+		"adcq $0, %[borrow]\n\t"
+		: [result] "+r"(_result), [lhs] "+r"(_lhs), [rhs] "+r"(_rhs), "+c"(blocks), [borrow] "+r"(borrow),
+			[t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3)
+		: [rest] "r"(rest)
+		: "cc", "memory");
+
+	return borrow;
+}
+
+sav::kernels::Limb sav::kernels::x86::Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	std::size_t blocks = _count / 2;
+	std::size_t rest = _count % 2;
+	Limb carry = 0;
+	Limb low0;
+	Limb high0;
+	Limb low1;
+	Limb high1;
+
+	// low[i] + high[i - 1] on the CF chain
+	__asm__ volatile(
+		"clc\n\t"
+		"1:\n\t"
+		"jrcxz 2f\n\t"
+		"mulxq (%[lhs]), %[low0], %[high0]\n\t"
+		"mulxq 8(%[lhs]), %[low1], %[high1]\n\t"
+		"adcxq %[carry], %[low0]\n\t"
+		"adcxq %[high0], %[low1]\n\t"
+		"movq %[low0], (%[result])\n\t"
+		"movq %[low1], 8(%[result])\n\t"
+		"movq %[high1], %[carry]\n\t"
+		"leaq 16(%[lhs]), %[lhs]\n\t"
+		"leaq 16(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"movq %[rest], %%rcx\n\t"
+		"jrcxz 3f\n\t"
+		"mulxq (%[lhs]), %[low0], %[high0]\n\t"
+		"adcxq %[carry], %[low0]\n\t"
+		"movq %[low0], (%[result])\n\t"
+		"movq %[high0], %[carry]\n\t"
+		"3:\n\t"
+		"movq $0, %[low0]\n\t"
+		"adcxq %[low0], %[carry]\n\t"
+		: [result] "+r"(_result), [lhs] "+r"(_lhs), "+c"(blocks), [carry] "+r"(carry),
+			[low0] "=&r"(low0), [high0] "=&r"(high0), [low1] "=&r"(low1), [high1] "=&r"(high1)
+		: [rest] "r"(rest), "d"(_rhs)
+		: "cc", "memory");
+
+	return carry;
+}
+
+sav::kernels::Limb sav::kernels::x86::AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	std::size_t blocks = _count / 2;
+	std::size_t rest = _count % 2;
+	Limb carry = 0;
+	Limb low0;
+	Limb high0;
+	Limb low1;
+	Limb high1;
+
+	// low[i] + high[i - 1] on the OF chain, + result[i] on the CF chain
+	__asm__ volatile(
+		"xorl %k[low0], %k[low0]\n\t"
+		"1:\n\t"
+		"jrcxz 2f\n\t"
+		"mulxq (%[lhs]), %[low0], %[high0]\n\t"
+		"mulxq 8(%[lhs]), %[low1], %[high1]\n\t"
+		"adoxq %[carry], %[low0]\n\t"
+		"adoxq %[high0], %[low1]\n\t"
+		"adcxq (%[result]), %[low0]\n\t"
+		"adcxq 8(%[result]), %[low1]\n\t"
+		"movq %[low0], (%[result])\n\t"
+		"movq %[low1], 8(%[result])\n\t"
+		"movq %[high1], %[carry]\n\t"
+		"leaq 16(%[lhs]), %[lhs]\n\t"
+		"leaq 16(%[result]), %[result]\n\t"
+		"leaq -1(%%rcx), %%rcx\n\t"
+		"jmp 1b\n\t"
+		"2:\n\t"
+		"movq %[rest], %%rcx\n\t"
+		"jrcxz 3f\n\t"
+		"mulxq (%[lhs]), %[low0], %[high0]\n\t"
+		"adoxq %[carry], %[low0]\n\t"
+		"adcxq (%[result]), %[low0]\n\t"
+		"movq %[low0], (%[result])\n\t"
+		"movq %[high0], %[carry]\n\t"
+		"3:\n\t"
+		"movq $0, %[low0]\n\t"
+		"adoxq %[low0], %[carry]\n\t"
+		"adcxq %[low0], %[carry]\n\t"
+		: [result] "+r"(_result), [lhs] "+r"(_lhs), "+c"(blocks), [carry] "+r"(carry),
+			[low0] "=&r"(low0), [high0] "=&r"(high0), [low1] "=&r"(low1), [high1] "=&r"(high1)
+		: [rest] "r"(rest), "d"(_rhs)
+		: "cc", "memory");
+
+	return carry;
+}
+
+#else
+
+// Other platforms and compilers : never selected, forwarding keeps the symbols available.
+
+bool sav::kernels::x86::Supported()
+{
+	return false;
+}
+
+sav::kernels::Limb sav::kernels::x86::AddN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	return portable::AddN(_result, _lhs, _rhs, _count);
+}
+
+sav::kernels::Limb sav::kernels::x86::SubN(Limb* _result, const Limb* _lhs, const Limb* _rhs, std::size_t _count)
+{
+	return portable::SubN(_result, _lhs, _rhs, _count);
+}
+
+sav::kernels::Limb sav::kernels::x86::Mul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	return portable::Mul1(_result, _lhs, _count, _rhs);
+}
+
+sav::kernels::Limb sav::kernels::x86::AddMul1(Limb* _result, const Limb* _lhs, std::size_t _count, Limb _rhs)
+{
+	return portable::AddMul1(_result, _lhs, _count, _rhs);
+}
+
+#endif
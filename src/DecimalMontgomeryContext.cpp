@@ -0,0 +1,244 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalMontgomeryContext.h"
+
+#include "DecimalKernels.h"
+
+#include <algorithm>
+
+sav::DecimalMontgomeryContext::DecimalMontgomeryContext(const sav::Decimal& _modulus)
+	:	m_modulusDecimal(_modulus)
+{
+	m_modulus = _modulus.ToLimbs();
+
+	if(!_modulus || m_modulus.empty() || (m_modulus[0] & 1) == 0 || (m_modulus.size() == 1 && m_modulus[0] == 1))
+	{
+		m_status = DecimalStatus::Error_InvalidArgument;
+		return;
+	}
+
+	m_inverse = 0 - kernels::InverseLimb(m_modulus[0]);
+
+	const std::size_t n = m_modulus.size();
+
+	// R mod N and R^2 mod N, the only divisions the context ever needs
+	kernels::Limbs quotient;
+
+	kernels::Limbs r(n + 1, 0);
+	r[n] = 1;
+	kernels::DivRem(r, m_modulus, quotient, m_one);
+	m_one.resize(n, 0);
+
+	kernels::Limbs rSquared(2 * n + 1, 0);
+	rSquared[2 * n] = 1;
+	kernels::DivRem(rSquared, m_modulus, quotient, m_rSquared);
+	m_rSquared.resize(n, 0);
+}
+
+sav::DecimalMontgomeryContext::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+const sav::Decimal& sav::DecimalMontgomeryContext::Modulus() const noexcept
+{
+	return m_modulusDecimal;
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::ToMontgomery(const sav::Decimal& _value) const
+{
+	if(!(*this) || !_value)
+	{
+		return InvalidResult();
+	}
+
+	return ToDecimal(Multiply(Reduce(_value), m_rSquared));
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::FromMontgomery(const sav::Decimal& _value) const
+{
+	if(!(*this) || !_value)
+	{
+		return InvalidResult();
+	}
+
+	std::vector<Limb> one(m_modulus.size(), 0);
+	one[0] = 1;
+
+	return ToDecimal(Multiply(Reduce(_value), one));
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::MontgomeryMul(const sav::Decimal& _lhs, const sav::Decimal& _rhs) const
+{
+	if(!(*this) || !_lhs || !_rhs)
+	{
+		return InvalidResult();
+	}
+
+	return ToDecimal(Multiply(Reduce(_lhs), Reduce(_rhs)));
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::MulMod(const sav::Decimal& _lhs, const sav::Decimal& _rhs) const
+{
+	if(!(*this) || !_lhs || !_rhs)
+	{
+		return InvalidResult();
+	}
+
+	// (lhs * R) * rhs / R == lhs * rhs
+	return ToDecimal(Multiply(Multiply(Reduce(_lhs), m_rSquared), Reduce(_rhs)));
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::PowMod(const sav::Decimal& _base, const sav::Decimal& _exponent) const
+{
+	if(!(*this) || !_base || !_exponent)
+	{
+		return InvalidResult();
+	}
+
+	const auto exponent = _exponent.ToLimbs();
+	const std::size_t exponentBits = kernels::BitLength(exponent);
+
+	auto bit = [&exponent](std::size_t _index)
+	{
+		return (exponent[_index / kernels::kLimbBits] >> (_index % kernels::kLimbBits)) & 1;
+	};
+
+	// Window size grows with the exponent, the table holds base^1, base^3, ..., base^(2^window - 1)
+	std::size_t window = 1;
+	for(std::size_t bits : {24, 80, 240, 672, 1792})
+	{
+		if(exponentBits > bits)
+		{
+			window++;
+		}
+	}
+
+	std::vector<std::vector<Limb>> oddPowers(std::size_t{1} << (window - 1));
+	oddPowers[0] = Multiply(Reduce(_base), m_rSquared);
+	if(oddPowers.size() > 1)
+	{
+		const auto squaredBase = Multiply(oddPowers[0], oddPowers[0]);
+		for(std::size_t i = 1; i < oddPowers.size(); i++)
+		{
+			oddPowers[i] = Multiply(oddPowers[i - 1], squaredBase);
+		}
+	}
+
+	auto result = m_one;
+
+	// Left-to-right: square for every bit, multiply once per window (a window starts and ends with a set bit)
+	for(std::size_t i = exponentBits; i > 0;)
+	{
+		if(bit(i - 1) == 0)
+		{
+			result = Multiply(result, result);
+			i--;
+			continue;
+		}
+
+		std::size_t length = std::min(window, i);
+		while(bit(i - length) == 0)
+		{
+			length--;
+		}
+
+		std::size_t windowValue = 0;
+		for(std::size_t j = 0; j < length; j++)
+		{
+			result = Multiply(result, result);
+			windowValue = (windowValue << 1) | bit(i - 1 - j);
+		}
+
+		result = Multiply(result, oddPowers[windowValue / 2]);
+		i -= length;
+	}
+
+	std::vector<Limb> one(m_modulus.size(), 0);
+	one[0] = 1;
+
+	return ToDecimal(Multiply(result, one));
+}
+
+std::vector<std::uint64_t> sav::DecimalMontgomeryContext::Reduce(const sav::Decimal& _value) const
+{
+	auto value = _value.ToLimbs();
+
+	if(kernels::Compare(value, m_modulus) >= 0)
+	{
+		kernels::Limbs quotient;
+		kernels::Limbs remainder;
+		kernels::DivRem(value, m_modulus, quotient, remainder);
+		value = remainder;
+	}
+
+	value.resize(m_modulus.size(), 0);
+
+	return value;
+}
+
+std::vector<std::uint64_t> sav::DecimalMontgomeryContext::Multiply(const std::vector<Limb>& _lhs, const std::vector<Limb>& _rhs) const
+{
+	const std::size_t n = m_modulus.size();
+
+	// t = (t + lhs * rhs[i] + m * N) / 2^64, where m makes the lowest limb zero
+	std::vector<Limb> t(n + 2, 0);
+	for(std::size_t i = 0; i < n; i++)
+	{
+		Limb carry = kernels::AddMul1(t.data(), _lhs.data(), n, _rhs[i]);
+		t[n] += carry;
+		t[n + 1] += t[n] < carry;
+
+		Limb m = t[0] * m_inverse;
+		carry = kernels::AddMul1(t.data(), m_modulus.data(), n, m);
+		t[n] += carry;
+		t[n + 1] += t[n] < carry;
+
+		std::copy(t.begin() + 1, t.end(), t.begin());
+		t[n + 1] = 0;
+	}
+
+	// t < 2N here
+	if(kernels::Compare(t, m_modulus) >= 0)
+	{
+		t[n] -= kernels::SubN(t.data(), t.data(), m_modulus.data(), n);
+	}
+
+	t.resize(n);
+
+	return t;
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::InvalidResult()
+{
+	Decimal result;
+	result.m_status = DecimalStatus::Error_InvalidArgument;
+	return result;
+}
+
+sav::Decimal sav::DecimalMontgomeryContext::ToDecimal(const std::vector<Limb>& _limbs)
+{
+	Decimal result;
+	result.AssignLimbs(_limbs);
+	return result;
+}
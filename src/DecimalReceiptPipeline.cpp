@@ -0,0 +1,503 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalReceiptPipeline.h"
+
+#include "DecimalBoundedQueue.h"
+#include "DecimalCharConv.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+	using Statistics = sav::DecimalReceiptPipeline::StageStatistics;
+
+	// Receipts handed from stage to stage; every stage fills in its own part.
+	struct Batch
+	{
+		std::uint64_t m_sequence = 0;
+
+		Clock::time_point m_started;
+
+		// Parse: the positions of receipt i are [m_offsets[i], m_offsets[i + 1]).
+		std::vector<std::size_t> m_offsets;
+		std::vector<sav::Decimal> m_prices;
+		std::vector<unsigned int> m_rates;
+
+		// Compute: VAT of every position.
+		std::vector<sav::Decimal> m_vats;
+
+		// Aggregate: sums per receipt.
+		std::vector<sav::Decimal> m_totals;
+		std::vector<sav::Decimal> m_vatTotals;
+
+		std::size_t Receipts() const
+		{
+			return m_offsets.size() - 1;
+		}
+	};
+
+	// A null batch marks the end of the input.
+	using BatchPointer = std::unique_ptr<Batch>;
+
+	using BatchQueue = sav::DecimalMpmcQueue<BatchPointer>;
+
+	std::uint64_t Nanoseconds(Clock::time_point _from, Clock::time_point _to)
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(_to - _from).count());
+	}
+
+	void AccountWork(Statistics& _statistics, std::size_t _receipts, Clock::time_point _from, Clock::time_point _to)
+	{
+		const std::uint64_t nanoseconds = Nanoseconds(_from, _to);
+
+		_statistics.Batches++;
+		_statistics.Receipts += _receipts;
+		_statistics.BusyNanoseconds += nanoseconds;
+		_statistics.MaxBatchNanoseconds = std::max(_statistics.MaxBatchNanoseconds, nanoseconds);
+	}
+
+	void AccountStall(Statistics& _statistics, Clock::time_point _from, Clock::time_point _to)
+	{
+		_statistics.StalledNanoseconds += Nanoseconds(_from, _to);
+	}
+
+	bool IsSpace(char _character)
+	{
+		return _character == ' ' || _character == '\t' || _character == '\r';
+	}
+
+	const char* SkipSpaces(const char* _first, const char* _last)
+	{
+		while(_first != _last && IsSpace(*_first))
+		{
+			_first++;
+		}
+
+		return _first;
+	}
+
+	/**
+	 * ParseReceipt - append the positions of one receipt line to the batch.
+	 * @return false if the line is not a receipt (the batch is then left unchanged)
+	 */
+	bool ParseReceipt(const std::string& _line, char _delimiter, unsigned int _defaultRate, Batch& _batch)
+	{
+		const std::size_t positions = _batch.m_prices.size();
+
+		const char* cursor = SkipSpaces(_line.data(), _line.data() + _line.size());
+		const char* last = _line.data() + _line.size();
+
+		while(cursor != last)
+		{
+			_batch.m_prices.emplace_back();
+			_batch.m_rates.push_back(_defaultRate);
+
+			auto price = sav::from_chars(cursor, last, _batch.m_prices.back());
+			bool valid = price.ec == std::errc{};
+			cursor = price.ptr;
+
+			if(valid && cursor != last && *cursor == '/')
+			{
+				auto rate = std::from_chars(cursor + 1, last, _batch.m_rates.back());
+				valid = rate.ec == std::errc{};
+				cursor = rate.ptr;
+			}
+
+			cursor = SkipSpaces(cursor, last);
+
+			if(valid && cursor != last)
+			{
+				valid = *cursor == _delimiter;
+				cursor = SkipSpaces(cursor + 1, last);
+				// a trailing delimiter is not a position
+				valid = valid && cursor != last;
+			}
+
+			if(!valid)
+			{
+				_batch.m_prices.resize(positions);
+				_batch.m_rates.resize(positions);
+				return false;
+			}
+		}
+
+		_batch.m_offsets.push_back(_batch.m_prices.size());
+
+		return true;
+	}
+
+	/**
+	 * ParseStage - split the input into batches.
+	 * @param _inFlight batches not written yet: a new one is started only below _credits, the format stage counts down
+	 */
+	void ParseStage(std::istream& _input, const sav::DecimalReceiptPipeline::Options& _options, std::size_t _consumers,
+		std::atomic<std::size_t>& _inFlight, std::size_t _credits, BatchQueue& _output, Statistics& _statistics,
+		sav::DecimalStatus& _status)
+	{
+		std::string line;
+
+		for(std::uint64_t sequence = 0; _status == sav::DecimalStatus::Ok; sequence++)
+		{
+			// Only this thread counts up, the limit cannot be overshot between the check and the increment.
+			const auto waiting = Clock::now();
+			while(_inFlight.load(std::memory_order_relaxed) >= _credits)
+			{
+				std::this_thread::yield();
+			}
+
+			_inFlight.fetch_add(1, std::memory_order_relaxed);
+			AccountStall(_statistics, waiting, Clock::now());
+
+			auto batch = std::make_unique<Batch>();
+			batch->m_sequence = sequence;
+			batch->m_started = Clock::now();
+			batch->m_offsets.push_back(0);
+
+			while(batch->Receipts() < _options.BatchSize && std::getline(_input, line))
+			{
+				if(!ParseReceipt(line, _options.Delimiter, _options.DefaultRate, *batch))
+				{
+					_status = sav::DecimalStatus::Error_InvalidArgument;
+					break;
+				}
+			}
+
+			if(_input.bad())
+			{
+				_status = sav::DecimalStatus::Error_IO;
+			}
+
+			const std::size_t receipts = batch->Receipts();
+			if(receipts == 0)
+			{
+				break;
+			}
+
+			const auto parsed = Clock::now();
+			AccountWork(_statistics, receipts, batch->m_started, parsed);
+
+			_output.Push(std::move(batch));
+			AccountStall(_statistics, parsed, Clock::now());
+
+			if(receipts < _options.BatchSize)
+			{
+				break;
+			}
+		}
+
+		for(std::size_t i = 0; i < _consumers; i++)
+		{
+			_output.Push(nullptr);
+		}
+	}
+
+	void ComputeStage(BatchQueue& _input, BatchQueue& _output, Statistics& _statistics)
+	{
+		// Operands of the last rate seen, positions of a receipt mostly share one.
+		unsigned int rate = 0;
+		sav::Decimal multiplier{0};
+		sav::Decimal divisor{100};
+
+		for(;;)
+		{
+			const auto waiting = Clock::now();
+
+			BatchPointer batch;
+			_input.Pop(batch);
+
+			const auto popped = Clock::now();
+			AccountStall(_statistics, waiting, popped);
+
+			if(!batch)
+			{
+				break;
+			}
+
+			batch->m_vats.resize(batch->m_prices.size());
+			for(std::size_t i = 0; i < batch->m_prices.size(); i++)
+			{
+				if(batch->m_rates[i] != rate)
+				{
+					rate = batch->m_rates[i];
+					multiplier = sav::Decimal{rate};
+					divisor = sav::Decimal{100 + std::uint64_t{rate}};
+				}
+
+				batch->m_vats[i] = (batch->m_prices[i] * multiplier).DivideAndRound(divisor, sav::DecimalRoundingMode::HalfUp);
+			}
+
+			const auto computed = Clock::now();
+			AccountWork(_statistics, batch->Receipts(), popped, computed);
+
+			_output.Push(std::move(batch));
+			AccountStall(_statistics, computed, Clock::now());
+		}
+
+		_output.Push(nullptr);
+	}
+
+	void AggregateStage(BatchQueue& _input, sav::DecimalSpscQueue<BatchPointer>& _output, std::size_t _producers,
+		Statistics& _statistics, std::size_t& _maxPending)
+	{
+		// Batches which overtook an earlier one in the compute stage, by sequence.
+		std::map<std::uint64_t, BatchPointer> pending;
+		std::uint64_t next = 0;
+
+		while(_producers != 0)
+		{
+			const auto waiting = Clock::now();
+
+			BatchPointer batch;
+			_input.Pop(batch);
+
+			AccountStall(_statistics, waiting, Clock::now());
+
+			if(!batch)
+			{
+				_producers--;
+				continue;
+			}
+
+			const std::uint64_t sequence = batch->m_sequence;
+			pending.emplace(sequence, std::move(batch));
+			_maxPending = std::max(_maxPending, pending.size());
+
+			for(auto it = pending.begin(); it != pending.end() && it->first == next; it = pending.begin())
+			{
+				const auto started = Clock::now();
+
+				Batch& ready = *it->second;
+				ready.m_totals.resize(ready.Receipts());
+				ready.m_vatTotals.resize(ready.Receipts());
+
+				for(std::size_t receipt = 0; receipt < ready.Receipts(); receipt++)
+				{
+					for(std::size_t i = ready.m_offsets[receipt]; i < ready.m_offsets[receipt + 1]; i++)
+					{
+						ready.m_totals[receipt] += ready.m_prices[i];
+						ready.m_vatTotals[receipt] += ready.m_vats[i];
+					}
+				}
+
+				const auto aggregated = Clock::now();
+				AccountWork(_statistics, ready.Receipts(), started, aggregated);
+
+				_output.Push(std::move(it->second));
+				AccountStall(_statistics, aggregated, Clock::now());
+
+				pending.erase(it);
+				next++;
+			}
+		}
+
+		_output.Push(nullptr);
+	}
+}
+
+double sav::DecimalReceiptPipeline::StageStatistics::Throughput() const noexcept
+{
+	return BusyNanoseconds == 0 ? 0.0 : static_cast<double>(Receipts) * 1e9 / static_cast<double>(BusyNanoseconds);
+}
+
+sav::DecimalReceiptPipeline::DecimalReceiptPipeline()
+	:	DecimalReceiptPipeline(Options{})
+{
+
+}
+
+sav::DecimalReceiptPipeline::DecimalReceiptPipeline(const Options& _options)
+	:	m_options(_options)
+{
+	m_options.BatchSize = std::max<std::size_t>(m_options.BatchSize, 1);
+	m_options.ComputeThreads = std::max<std::size_t>(m_options.ComputeThreads, 1);
+}
+
+sav::DecimalStatus sav::DecimalReceiptPipeline::Run(std::istream& _input, std::ostream& _output)
+{
+	m_statistics = {};
+	m_receipts = 0;
+	m_latencySum = 0;
+	m_latencyMax = 0;
+	m_maxReordered = 0;
+
+	// A batch in every compute worker, plus full queues before and after them.
+	const std::size_t credits = m_options.ComputeThreads + 2 * m_options.QueueCapacity;
+	std::atomic<std::size_t> inFlight{0};
+
+	BatchQueue parsed{m_options.QueueCapacity};
+	BatchQueue computed{m_options.QueueCapacity};
+	DecimalSpscQueue<BatchPointer> aggregated{m_options.QueueCapacity};
+
+	DecimalStatus parseStatus = DecimalStatus::Ok;
+	std::vector<StageStatistics> computeStatistics(m_options.ComputeThreads);
+
+	std::vector<std::thread> threads;
+	threads.emplace_back([&]()
+	{
+		ParseStage(_input, m_options, m_options.ComputeThreads, inFlight, credits, parsed,
+			m_statistics[static_cast<std::size_t>(Stage::Parse)], parseStatus);
+	});
+
+	for(auto& statistics : computeStatistics)
+	{
+		threads.emplace_back([&]()
+		{
+			ComputeStage(parsed, computed, statistics);
+		});
+	}
+
+	threads.emplace_back([&]()
+	{
+		AggregateStage(computed, aggregated, m_options.ComputeThreads, m_statistics[static_cast<std::size_t>(Stage::Aggregate)],
+			m_maxReordered);
+	});
+
+	// Format stage. After an output error the batches are still drained, so that every stage can finish.
+	StageStatistics& statistics = m_statistics[static_cast<std::size_t>(Stage::Format)];
+	bool written = true;
+	std::string text;
+
+	for(;;)
+	{
+		const auto waiting = Clock::now();
+
+		BatchPointer batch;
+		aggregated.Pop(batch);
+
+		const auto popped = Clock::now();
+		AccountStall(statistics, waiting, popped);
+
+		if(!batch)
+		{
+			break;
+		}
+
+		std::size_t length = 0;
+		for(std::size_t receipt = 0; receipt < batch->Receipts(); receipt++)
+		{
+			length += to_chars_max_length(batch->m_totals[receipt]) + to_chars_max_length(batch->m_vatTotals[receipt]) + 2;
+		}
+
+		text.resize(length);
+		char* cursor = &text[0];
+		char* last = cursor + text.size();
+
+		for(std::size_t receipt = 0; receipt < batch->Receipts(); receipt++)
+		{
+			cursor = to_chars(cursor, last, batch->m_totals[receipt]).ptr;
+			*cursor++ = m_options.Delimiter;
+			cursor = to_chars(cursor, last, batch->m_vatTotals[receipt]).ptr;
+			*cursor++ = '\n';
+		}
+
+		if(written)
+		{
+			_output.write(text.data(), cursor - text.data());
+			written = static_cast<bool>(_output);
+		}
+
+		const auto formatted = Clock::now();
+		AccountWork(statistics, batch->Receipts(), popped, formatted);
+
+		if(written)
+		{
+			m_receipts += batch->Receipts();
+		}
+
+		const std::uint64_t latency = Nanoseconds(batch->m_started, formatted);
+		m_latencySum += latency;
+		m_latencyMax = std::max(m_latencyMax, latency);
+
+		// The batch is written, its credit goes back to the parse stage.
+		inFlight.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	StageStatistics& compute = m_statistics[static_cast<std::size_t>(Stage::Compute)];
+	for(const auto& it : computeStatistics)
+	{
+		compute.Batches += it.Batches;
+		compute.Receipts += it.Receipts;
+		compute.BusyNanoseconds += it.BusyNanoseconds;
+		compute.StalledNanoseconds += it.StalledNanoseconds;
+		compute.MaxBatchNanoseconds = std::max(compute.MaxBatchNanoseconds, it.MaxBatchNanoseconds);
+	}
+
+	if(parseStatus != DecimalStatus::Ok)
+	{
+		return parseStatus;
+	}
+
+	return written ? DecimalStatus::Ok : DecimalStatus::Error_IO;
+}
+
+std::uint64_t sav::DecimalReceiptPipeline::Receipts() const noexcept
+{
+	return m_receipts;
+}
+
+const sav::DecimalReceiptPipeline::StageStatistics& sav::DecimalReceiptPipeline::Statistics(Stage _stage) const noexcept
+{
+	return m_statistics[static_cast<std::size_t>(_stage)];
+}
+
+std::uint64_t sav::DecimalReceiptPipeline::MeanLatencyNanoseconds() const noexcept
+{
+	const std::uint64_t batches = m_statistics[static_cast<std::size_t>(Stage::Format)].Batches;
+
+	return batches == 0 ? 0 : m_latencySum / batches;
+}
+
+std::uint64_t sav::DecimalReceiptPipeline::MaxLatencyNanoseconds() const noexcept
+{
+	return m_latencyMax;
+}
+
+std::size_t sav::DecimalReceiptPipeline::MaxReorderedBatches() const noexcept
+{
+	return m_maxReordered;
+}
+
+const char* sav::DecimalReceiptPipeline::Name(Stage _stage) noexcept
+{
+	switch(_stage)
+	{
+		case Stage::Parse: return "Parse";
+		case Stage::Compute: return "Compute";
+		case Stage::Aggregate: return "Aggregate";
+		case Stage::Format: return "Format";
+		default: return "Unknown";
+	}
+}
@@ -0,0 +1,303 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalSort.h"
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+
+namespace
+{
+	// Normalized digits of a value: m_digits * 2^(64 * m_zeroLimbs).
+	struct Operand
+	{
+		const std::uint8_t* m_digits;
+		std::size_t m_size;
+		std::size_t m_zeroLimbs;
+	};
+
+	// Current sort key of the value at m_index.
+	struct Entry
+	{
+		std::uint64_t m_key;
+		std::size_t m_index;
+	};
+
+	// Kept value of Dedupe with its hash, next to each other: a probe touches one cache line.
+	struct Slot
+	{
+		std::size_t m_hash;
+		std::size_t m_index;
+	};
+
+	// Ranges shorter than this are sorted by comparison, a radix pass would be spent mostly on its histogram.
+	constexpr std::size_t kSmallRange = 64;
+
+	constexpr std::size_t kLimbBytes = sizeof(std::uint64_t);
+
+	std::size_t LimbCount(const Operand& _operand)
+	{
+		return _operand.m_zeroLimbs + (_operand.m_size + kLimbBytes - 1) / kLimbBytes;
+	}
+
+	/**
+	 * LimbOf - 64-bit limb of a value.
+	 * @param _operand
+	 * @param _limb index of the limb, 0 is the least significant
+	 */
+	std::uint64_t LimbOf(const Operand& _operand, std::size_t _limb)
+	{
+		if(_limb < _operand.m_zeroLimbs)
+		{
+			return 0;
+		}
+
+		const std::size_t first = (_limb - _operand.m_zeroLimbs) * kLimbBytes;
+		std::uint64_t limb = 0;
+
+		for(std::size_t i = std::min(_operand.m_size, first + kLimbBytes); i-- > first; )
+		{
+			limb = (limb << 8) | _operand.m_digits[i];
+		}
+
+		return limb;
+	}
+
+	/**
+	 * SortByKeys - stable LSD radix sort of entries by m_key, a byte per pass.
+	 * All eight histograms are built in one pass, a byte which is the same for every entry costs nothing more.
+	 */
+	void SortByKeys(Entry* _first, Entry* _last, std::vector<Entry>& _scratch)
+	{
+		const std::size_t count = static_cast<std::size_t>(_last - _first);
+
+		if(count < kSmallRange)
+		{
+			std::stable_sort(_first, _last, [](const Entry& _lhs, const Entry& _rhs) { return _lhs.m_key < _rhs.m_key; });
+			return;
+		}
+
+		std::array<std::array<std::size_t, 256>, kLimbBytes> histograms{};
+
+		for(const Entry* entry = _first; entry != _last; entry++)
+		{
+			for(std::size_t byte = 0; byte < kLimbBytes; byte++)
+			{
+				histograms[byte][(entry->m_key >> (8 * byte)) & 0xFF]++;
+			}
+		}
+
+		_scratch.resize(count);
+		Entry* from = _first;
+		Entry* to = _scratch.data();
+
+		for(std::size_t byte = 0; byte < kLimbBytes; byte++)
+		{
+			std::array<std::size_t, 256>& histogram = histograms[byte];
+			const std::size_t shift = 8 * byte;
+
+			if(histogram[(from->m_key >> shift) & 0xFF] == count)
+			{
+				continue;
+			}
+
+			std::size_t offset = 0;
+
+			for(std::size_t& bucket : histogram)
+			{
+				offset += bucket;
+				bucket = offset - bucket;
+			}
+
+			for(std::size_t i = 0; i < count; i++)
+			{
+				to[histogram[(from[i].m_key >> shift) & 0xFF]++] = from[i];
+			}
+
+			std::swap(from, to);
+		}
+
+		if(from != _first)
+		{
+			std::copy(from, from + count, _first);
+		}
+	}
+
+	/**
+	 * SortByLimbs - order entries of values with the same limb count, most significant limb first.
+	 * Runs of equal limbs are ordered by the next lower limb; an explicit stack is used instead of recursion,
+	 * as equal values of many limbs would otherwise nest a call per limb.
+	 * @param _limb most significant limb index of the values
+	 */
+	void SortByLimbs(Entry* _first, Entry* _last, std::size_t _limb, const std::vector<Operand>& _operands, std::vector<Entry>& _scratch)
+	{
+		std::vector<std::tuple<Entry*, Entry*, std::size_t>> ranges{{_first, _last, _limb}};
+
+		while(!ranges.empty())
+		{
+			Entry* first;
+			Entry* last;
+			std::size_t limb;
+			std::tie(first, last, limb) = ranges.back();
+			ranges.pop_back();
+
+			for(Entry* entry = first; entry != last; entry++)
+			{
+				entry->m_key = LimbOf(_operands[entry->m_index], limb);
+			}
+
+			SortByKeys(first, last, _scratch);
+
+			if(limb == 0)
+			{
+				continue;
+			}
+
+			for(Entry* run = first; run != last; )
+			{
+				Entry* next = run + 1;
+
+				while(next != last && next->m_key == run->m_key)
+				{
+					next++;
+				}
+
+				if(next - run > 1)
+				{
+					ranges.emplace_back(run, next, limb - 1);
+				}
+
+				run = next;
+			}
+		}
+	}
+}
+
+void sav::RadixSort(std::vector<sav::Decimal>& _values)
+{
+	const std::size_t count = _values.size();
+
+	if(count < 2)
+	{
+		return;
+	}
+
+	std::vector<Operand> operands(count);
+	std::vector<Entry> entries(count);
+
+	for(std::size_t i = 0; i < count; i++)
+	{
+		// Read through a const reference: non-const data() would detach shared digits.
+		const Decimal& value = _values[i];
+		operands[i] = {value.m_digits.data(), value.m_digits.size(), value.m_zeroLimbs};
+		entries[i] = {LimbCount(operands[i]), i};
+	}
+
+	std::vector<Entry> scratch;
+
+	// A normalized value with more limbs is larger.
+	SortByKeys(entries.data(), entries.data() + count, scratch);
+
+	for(Entry* group = entries.data(), *end = entries.data() + count; group != end; )
+	{
+		Entry* next = group + 1;
+
+		while(next != end && next->m_key == group->m_key)
+		{
+			next++;
+		}
+
+		// Every value has at least one limb: without a digit buffer (zero or moved-from) it reads as the digit 0.
+		if(next - group > 1)
+		{
+			SortByLimbs(group, next, group->m_key - 1, operands, scratch);
+		}
+
+		group = next;
+	}
+
+	std::vector<Decimal> sorted;
+	sorted.reserve(count);
+
+	for(const Entry& entry : entries)
+	{
+		sorted.push_back(std::move(_values[entry.m_index]));
+	}
+
+	_values.swap(sorted);
+}
+
+void sav::Dedupe(std::vector<sav::Decimal>& _values)
+{
+	const std::size_t count = _values.size();
+
+	if(count < 2)
+	{
+		return;
+	}
+
+	// Open addressing with linear probing over positions of kept values, at most half full.
+	std::size_t capacity = 1;
+
+	while(capacity < 2 * count)
+	{
+		capacity <<= 1;
+	}
+
+	constexpr std::size_t kEmpty = static_cast<std::size_t>(-1);
+	std::vector<Slot> slots(capacity, Slot{0, kEmpty});
+	std::size_t kept = 0;
+
+	for(std::size_t i = 0; i < count; i++)
+	{
+		const std::size_t hash = _values[i].Hash();
+		std::size_t slot = hash & (capacity - 1);
+		bool repeated = false;
+
+		while(slots[slot].m_index != kEmpty)
+		{
+			if(slots[slot].m_hash == hash && _values[slots[slot].m_index] == _values[i])
+			{
+				repeated = true;
+				break;
+			}
+
+			slot = (slot + 1) & (capacity - 1);
+		}
+
+		if(repeated)
+		{
+			continue;
+		}
+
+		if(kept != i)
+		{
+			_values[kept] = std::move(_values[i]);
+		}
+
+		slots[slot] = {hash, kept};
+		kept++;
+	}
+
+	_values.erase(_values.begin() + static_cast<std::ptrdiff_t>(kept), _values.end());
+}
@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalStreamParser.h"
+
+#include "DecimalCharConv.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	bool IsBlank(char _character)
+	{
+		return _character == ' ' || _character == '\t' || _character == '\r';
+	}
+}
+
+sav::DecimalStreamParser::DecimalStreamParser(std::istream& _input, char _delimiter, std::size_t _chunkSize)
+	:	m_input(&_input),
+		m_buffer(2 * std::max<std::size_t>(_chunkSize, 1)),
+		m_chunkSize(std::max<std::size_t>(_chunkSize, 1)),
+		m_delimiter(_delimiter)
+{
+
+}
+
+sav::DecimalStreamParser::DecimalStreamParser(const char* _data, std::size_t _size, char _delimiter)
+	:	m_cursor(_data),
+		m_end(_data + _size),
+		m_delimiter(_delimiter),
+		m_exhausted(true)
+{
+
+}
+
+bool sav::DecimalStreamParser::Next(sav::Decimal& _value)
+{
+	while(m_status == DecimalStatus::Ok)
+	{
+		const char* separator = std::find_if(m_cursor, m_end, [this](char _character)
+		{
+			return _character == m_delimiter || _character == '\n';
+		});
+
+		// The field may continue in the next chunk.
+		if(separator == m_end && !m_exhausted)
+		{
+			Refill();
+			continue;
+		}
+
+		const char* first = m_cursor;
+		const char* last = separator;
+		m_cursor = separator == m_end ? m_end : separator + 1;
+
+		while(first != last && IsBlank(*first))
+		{
+			first++;
+		}
+
+		while(last != first && IsBlank(*(last - 1)))
+		{
+			last--;
+		}
+
+		if(first == last)
+		{
+			if(separator == m_end)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		if(!Convert(first, last, _value))
+		{
+			m_status = DecimalStatus::Error_InvalidArgument;
+			return false;
+		}
+
+		m_fields++;
+		return true;
+	}
+
+	return false;
+}
+
+std::size_t sav::DecimalStreamParser::Fill(std::vector<sav::Decimal>& _batch, std::size_t _count)
+{
+	std::size_t filled = 0;
+	Decimal value;
+
+	while(filled < _count && Next(value))
+	{
+		_batch.push_back(value);
+		filled++;
+	}
+
+	return filled;
+}
+
+sav::DecimalStatus sav::DecimalStreamParser::Status() const noexcept
+{
+	return m_status;
+}
+
+sav::DecimalStreamParser::operator bool() const noexcept
+{
+	return m_status == DecimalStatus::Ok;
+}
+
+std::uint64_t sav::DecimalStreamParser::Fields() const noexcept
+{
+	return m_fields;
+}
+
+void sav::DecimalStreamParser::Refill()
+{
+	std::size_t tail = m_end - m_cursor;
+
+	// The buffer starts with room for a chunk after a tail of up to one chunk,
+	// so it only grows when a single field is longer than a chunk.
+	if(m_buffer.size() < tail + m_chunkSize)
+	{
+		std::vector<char> buffer(tail + m_chunkSize);
+		std::copy(m_cursor, m_end, buffer.data());
+		m_buffer.swap(buffer);
+	}
+	else if(tail != 0)
+	{
+		std::memmove(m_buffer.data(), m_cursor, tail);
+	}
+
+	m_input->read(m_buffer.data() + tail, static_cast<std::streamsize>(m_chunkSize));
+	std::size_t read = static_cast<std::size_t>(m_input->gcount());
+
+	if(m_input->bad())
+	{
+		m_status = DecimalStatus::Error_IO;
+	}
+
+	if(!(*m_input))
+	{
+		m_exhausted = true;
+	}
+
+	m_cursor = m_buffer.data();
+	m_end = m_cursor + tail + read;
+}
+
+bool sav::DecimalStreamParser::Convert(const char* _first, const char* _last, sav::Decimal& _value)
+{
+	auto conversion = from_chars(_first, _last, _value);
+
+	return conversion.ec == std::errc{} && conversion.ptr == _last;
+}
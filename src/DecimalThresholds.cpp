@@ -0,0 +1,261 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalThresholds.h"
+#include "DecimalKernels.h"
+
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+// A header written by Decimal_VLN_BCD_tune --header replaces the defaults below.
+#ifdef DECIMAL_VLN_BCD_THRESHOLDS_HEADER
+#include DECIMAL_VLN_BCD_THRESHOLDS_HEADER
+#endif
+
+#ifndef DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD
+#define DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD
+#define DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD 48
+#endif
+
+#ifndef DECIMAL_VLN_BCD_BASE10_THRESHOLD
+#define DECIMAL_VLN_BCD_BASE10_THRESHOLD 30
+#endif
+
+// Compiled-in values are held to the same minimums as the ones applied at runtime.
+static_assert(DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD >= sav::DecimalThresholds::kMinKaratsuba,
+	"DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD is below DecimalThresholds::kMinKaratsuba");
+static_assert(DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD >= sav::DecimalThresholds::kMinBurnikelZiegler,
+	"DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD is below DecimalThresholds::kMinBurnikelZiegler");
+static_assert(DECIMAL_VLN_BCD_BASE10_THRESHOLD >= sav::DecimalThresholds::kMinBase10,
+	"DECIMAL_VLN_BCD_BASE10_THRESHOLD is below DecimalThresholds::kMinBase10");
+
+namespace
+{
+	// Values in use, read by the kernels on every dispatch.
+	struct State
+	{
+		std::atomic<std::size_t> m_karatsuba;
+		std::atomic<std::size_t> m_burnikelZiegler;
+		std::atomic<std::size_t> m_base10;
+
+		explicit State(const sav::DecimalThresholds& _thresholds)
+			:	m_karatsuba(_thresholds.Karatsuba),
+				m_burnikelZiegler(_thresholds.BurnikelZiegler),
+				m_base10(_thresholds.Base10)
+		{
+
+		}
+	};
+
+	// Defaults, overridden by the DECIMAL_VLN_BCD_THRESHOLDS file if it parses and is valid.
+	sav::DecimalThresholds Startup()
+	{
+		auto thresholds = sav::DecimalThresholds::Defaults();
+
+		const char* path = std::getenv("DECIMAL_VLN_BCD_THRESHOLDS");
+		if(path == nullptr || *path == '\0')
+		{
+			return thresholds;
+		}
+
+		auto loaded = thresholds;
+		if(sav::DecimalThresholds::Load(path, loaded) != sav::DecimalStatus::Ok ||
+			loaded.Karatsuba < sav::DecimalThresholds::kMinKaratsuba ||
+			loaded.BurnikelZiegler < sav::DecimalThresholds::kMinBurnikelZiegler ||
+			loaded.Base10 < sav::DecimalThresholds::kMinBase10)
+		{
+			return thresholds;
+		}
+
+		return loaded;
+	}
+
+	State& InUse()
+	{
+		static State state{Startup()};
+		return state;
+	}
+
+	std::string_view TrimSpaces(std::string_view _text)
+	{
+		const auto first = _text.find_first_not_of(" \t\r");
+		if(first == std::string_view::npos)
+		{
+			return {};
+		}
+
+		return _text.substr(first, _text.find_last_not_of(" \t\r") - first + 1);
+	}
+}
+
+std::size_t sav::kernels::KaratsubaThreshold()
+{
+	return InUse().m_karatsuba.load(std::memory_order_relaxed);
+}
+
+std::size_t sav::kernels::BurnikelZieglerThreshold()
+{
+	return InUse().m_burnikelZiegler.load(std::memory_order_relaxed);
+}
+
+std::size_t sav::kernels::Base10Threshold()
+{
+	return InUse().m_base10.load(std::memory_order_relaxed);
+}
+
+sav::DecimalThresholds sav::DecimalThresholds::Defaults()
+{
+	DecimalThresholds result;
+	result.Karatsuba = DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD;
+	result.BurnikelZiegler = DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD;
+	result.Base10 = DECIMAL_VLN_BCD_BASE10_THRESHOLD;
+
+	return result;
+}
+
+sav::DecimalThresholds sav::DecimalThresholds::Current()
+{
+	DecimalThresholds result;
+	result.Karatsuba = kernels::KaratsubaThreshold();
+	result.BurnikelZiegler = kernels::BurnikelZieglerThreshold();
+	result.Base10 = kernels::Base10Threshold();
+
+	return result;
+}
+
+sav::DecimalStatus sav::DecimalThresholds::Apply(const DecimalThresholds& _thresholds)
+{
+	if(_thresholds.Karatsuba < kMinKaratsuba ||
+		_thresholds.BurnikelZiegler < kMinBurnikelZiegler ||
+		_thresholds.Base10 < kMinBase10)
+	{
+		return DecimalStatus::Error_InvalidArgument;
+	}
+
+	auto& state = InUse();
+	state.m_karatsuba.store(_thresholds.Karatsuba, std::memory_order_relaxed);
+	state.m_burnikelZiegler.store(_thresholds.BurnikelZiegler, std::memory_order_relaxed);
+	state.m_base10.store(_thresholds.Base10, std::memory_order_relaxed);
+
+	return DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalThresholds::Parse(std::string_view _config, DecimalThresholds& _thresholds)
+{
+	auto result = _thresholds;
+
+	while(!_config.empty())
+	{
+		auto end = _config.find('\n');
+		auto line = _config.substr(0, end);
+		_config.remove_prefix(end == std::string_view::npos ? _config.size() : end + 1);
+
+		line = TrimSpaces(line.substr(0, line.find('#')));
+		if(line.empty())
+		{
+			continue;
+		}
+
+		auto separator = line.find('=');
+		if(separator == std::string_view::npos)
+		{
+			return DecimalStatus::Error_InvalidArgument;
+		}
+
+		auto name = TrimSpaces(line.substr(0, separator));
+		auto text = TrimSpaces(line.substr(separator + 1));
+
+		std::size_t value = 0;
+		auto parsed = std::from_chars(text.data(), text.data() + text.size(), value);
+		if(text.empty() || parsed.ec != std::errc{} || parsed.ptr != text.data() + text.size())
+		{
+			return DecimalStatus::Error_InvalidArgument;
+		}
+
+		if(name == "karatsuba")
+		{
+			result.Karatsuba = value;
+		}
+		else if(name == "burnikel_ziegler")
+		{
+			result.BurnikelZiegler = value;
+		}
+		else if(name == "base10")
+		{
+			result.Base10 = value;
+		}
+		else
+		{
+			return DecimalStatus::Error_InvalidArgument;
+		}
+	}
+
+	_thresholds = result;
+
+	return DecimalStatus::Ok;
+}
+
+sav::DecimalStatus sav::DecimalThresholds::Load(const std::string& _path, DecimalThresholds& _thresholds)
+{
+	std::ifstream file(_path);
+	if(!file)
+	{
+		return DecimalStatus::Error_IO;
+	}
+
+	std::ostringstream text;
+	text << file.rdbuf();
+	if(file.bad())
+	{
+		return DecimalStatus::Error_IO;
+	}
+
+	return Parse(text.str(), _thresholds);
+}
+
+std::string sav::DecimalThresholds::ToConfig() const
+{
+	std::ostringstream result;
+	result << "# Decimal_VLN_BCD thresholds, in 64-bit limbs\n";
+	result << "karatsuba = " << Karatsuba << "\n";
+	result << "burnikel_ziegler = " << BurnikelZiegler << "\n";
+	result << "base10 = " << Base10 << "\n";
+
+	return result.str();
+}
+
+std::string sav::DecimalThresholds::ToHeader() const
+{
+	std::ostringstream result;
+	result << "// Decimal_VLN_BCD thresholds, in 64-bit limbs (generated by Decimal_VLN_BCD_tune)\n";
+	result << "#define DECIMAL_VLN_BCD_KARATSUBA_THRESHOLD " << Karatsuba << "\n";
+	result << "#define DECIMAL_VLN_BCD_BURNIKEL_ZIEGLER_THRESHOLD " << BurnikelZiegler << "\n";
+	result << "#define DECIMAL_VLN_BCD_BASE10_THRESHOLD " << Base10 << "\n";
+
+	return result.str();
+}
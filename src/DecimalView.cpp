@@ -0,0 +1,326 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalView.h"
+
+#include "DecimalIntegerDivisionResult.h"
+#include "DecimalKernels.h"
+
+#include <algorithm>
+
+sav::DecimalView::DecimalView() noexcept
+	:	m_digits(nullptr),
+		m_size(0),
+		m_zeroLimbs(0)
+{
+
+}
+
+sav::DecimalView::DecimalView(const std::uint8_t* _digits, std::size_t _count) noexcept
+	:	m_digits(_digits),
+		m_size(_count),
+		m_zeroLimbs(0)
+{
+	while(m_size != 0 && m_digits[m_size - 1] == 0x00)
+	{
+		m_size--;
+	}
+
+	// Same form as a Decimal: whole zero limbs below the most significant digit are implicit.
+	while(m_size > sizeof(std::uint64_t) &&
+		std::all_of(m_digits, m_digits + sizeof(std::uint64_t), [](std::uint8_t _digit) { return _digit == 0x00; }))
+	{
+		m_digits += sizeof(std::uint64_t);
+		m_size -= sizeof(std::uint64_t);
+		m_zeroLimbs++;
+	}
+}
+
+sav::DecimalView::DecimalView(const sav::Decimal& _decimal) noexcept
+	:	DecimalView(_decimal.m_digits.data(), _decimal.m_digits.size())
+{
+	// Decimal digits are normalized already, the view above has no implicit zero limbs of its own.
+	if(m_size != 0)
+	{
+		m_zeroLimbs = _decimal.m_zeroLimbs;
+	}
+}
+
+namespace
+{
+	// Viewed value as trimmed limbs, _dropLimbs of the implicit zero limbs left out.
+	sav::kernels::Limbs ToLimbs(const sav::DecimalView& _view, std::size_t _dropLimbs)
+	{
+		return sav::kernels::ToLimbs(_view.Digits(), _view.Size(), _view.ZeroLimbs() - _dropLimbs);
+	}
+
+	// Digit _index of the whole value, implicit zeros included.
+	std::uint8_t DigitAt(const sav::DecimalView& _view, std::size_t _index) noexcept
+	{
+		const std::size_t zeros = _view.ZeroLimbs() * sizeof(std::uint64_t);
+		return _index < zeros ? 0x00 : _view.Digits()[_index - zeros];
+	}
+
+	// Count of digits of the whole value.
+	std::size_t TotalSize(const sav::DecimalView& _view) noexcept
+	{
+		return _view.Size() + _view.ZeroLimbs() * sizeof(std::uint64_t);
+	}
+}
+
+std::size_t sav::DecimalView::Parse(const std::uint8_t* _data, std::size_t _size, sav::DecimalView& _view) noexcept
+{
+	// LEB128 count of digits, at most 10 bytes for 64 bits
+	std::uint64_t count = 0;
+	std::size_t header = 0;
+	for(;; header++)
+	{
+		if(header == _size || header == 10)
+		{
+			return 0;
+		}
+
+		count |= static_cast<std::uint64_t>(_data[header] & 0x7F) << (7 * header);
+
+		if((_data[header] & 0x80) == 0)
+		{
+			header++;
+			break;
+		}
+	}
+
+	if(count > _size - header)
+	{
+		return 0;
+	}
+
+	_view = DecimalView{_data + header, static_cast<std::size_t>(count)};
+	return header + static_cast<std::size_t>(count);
+}
+
+void sav::DecimalView::Serialize(std::vector<std::uint8_t>& _buffer) const
+{
+	std::size_t count = TotalSize(*this);
+
+	// LEB128 : 7 bits per byte, high bit set when more bytes follow
+	do
+	{
+		std::uint8_t byte = count & 0x7F;
+		count >>= 7;
+		_buffer.push_back(count != 0 ? (byte | 0x80) : byte);
+	}
+	while(count != 0);
+
+	// the encoding has no implicit zeros
+	_buffer.insert(_buffer.end(), m_zeroLimbs * sizeof(std::uint64_t), std::uint8_t{0x00});
+	_buffer.insert(_buffer.end(), m_digits, m_digits + m_size);
+}
+
+std::size_t sav::DecimalView::SerializedSize() const noexcept
+{
+	std::size_t count = TotalSize(*this);
+	std::size_t header = 1;
+
+	while(count >= 0x80)
+	{
+		count >>= 7;
+		header++;
+	}
+
+	return header + TotalSize(*this);
+}
+
+sav::Decimal sav::DecimalView::ToDecimal() const
+{
+	Decimal result;
+
+	if(m_size != 0)
+	{
+		result.m_digits.assign(m_digits, m_digits + m_size);
+		result.m_zeroLimbs = m_zeroLimbs;
+	}
+
+	return result;
+}
+
+const std::uint8_t* sav::DecimalView::Digits() const noexcept
+{
+	return m_digits;
+}
+
+std::size_t sav::DecimalView::Size() const noexcept
+{
+	return m_size;
+}
+
+std::size_t sav::DecimalView::ZeroLimbs() const noexcept
+{
+	return m_zeroLimbs;
+}
+
+bool sav::DecimalView::EqualsZero() const noexcept
+{
+	return m_size == 0;
+}
+
+int sav::DecimalView::Compare(const sav::DecimalView& _rhs) const noexcept
+{
+	const std::size_t size = TotalSize(*this);
+	if(size != TotalSize(_rhs))
+	{
+		return size < TotalSize(_rhs) ? -1 : 1;
+	}
+
+	// Digits are compared down to the higher of both zero prefixes, below it one side is all zeros.
+	const std::size_t zeros = std::max(m_zeroLimbs, _rhs.m_zeroLimbs) * sizeof(std::uint64_t);
+	for(std::size_t i = size; i-- > zeros;)
+	{
+		const std::uint8_t lhs = DigitAt(*this, i);
+		const std::uint8_t rhs = DigitAt(_rhs, i);
+
+		if(lhs != rhs)
+		{
+			return lhs < rhs ? -1 : 1;
+		}
+	}
+
+	if(m_zeroLimbs == _rhs.m_zeroLimbs)
+	{
+		return 0;
+	}
+
+	// The side with fewer implicit zero limbs has a nonzero digit below the other one's prefix.
+	return m_zeroLimbs < _rhs.m_zeroLimbs ? 1 : -1;
+}
+
+bool sav::DecimalView::operator==(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) == 0;
+}
+
+bool sav::DecimalView::operator!=(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) != 0;
+}
+
+bool sav::DecimalView::operator<(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) < 0;
+}
+
+bool sav::DecimalView::operator>(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) > 0;
+}
+
+bool sav::DecimalView::operator<=(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) <= 0;
+}
+
+bool sav::DecimalView::operator>=(const sav::DecimalView& _rhs) const noexcept
+{
+	return Compare(_rhs) >= 0;
+}
+
+sav::Decimal sav::DecimalView::operator+(const sav::DecimalView& _rhs) const
+{
+	// The common implicit zero limbs are skipped, the result keeps them.
+	const std::size_t zeroLimbs = std::min(m_zeroLimbs, _rhs.m_zeroLimbs);
+
+	auto lhs = ToLimbs(*this, zeroLimbs);
+	auto rhs = ToLimbs(_rhs, zeroLimbs);
+
+	// the longer operand goes first, carry-out becomes the top limb
+	if(lhs.size() < rhs.size())
+	{
+		std::swap(lhs, rhs);
+	}
+
+	kernels::Limbs sum(lhs.size() + 1);
+	sum[lhs.size()] = kernels::Add(sum.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+
+	Decimal result;
+	result.AssignLimbs(sum, zeroLimbs);
+
+	return result;
+}
+
+sav::Decimal sav::DecimalView::operator-(const sav::DecimalView& _rhs) const
+{
+	Decimal result;
+
+	const int comparison = Compare(_rhs);
+	if(comparison < 0)
+	{
+		result.m_status = DecimalStatus::Error_Underflow;
+		return result;
+	}
+
+	if(comparison == 0)
+	{
+		return result;
+	}
+
+	const std::size_t zeroLimbs = std::min(m_zeroLimbs, _rhs.m_zeroLimbs);
+
+	auto lhs = ToLimbs(*this, zeroLimbs);
+	auto rhs = ToLimbs(_rhs, zeroLimbs);
+
+	kernels::Limbs difference(lhs.size());
+	kernels::Sub(difference.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+
+	result.AssignLimbs(difference, zeroLimbs);
+
+	return result;
+}
+
+sav::Decimal sav::DecimalView::operator*(const sav::DecimalView& _rhs) const
+{
+	Decimal result;
+	result.AssignLimbs(kernels::Multiply(ToLimbs(*this, m_zeroLimbs), ToLimbs(_rhs, _rhs.m_zeroLimbs)), m_zeroLimbs + _rhs.m_zeroLimbs);
+
+	return result;
+}
+
+sav::DecimalIntegerDivisionResult sav::DecimalView::operator/(const sav::DecimalView& _rhs) const
+{
+	DecimalIntegerDivisionResult result;
+
+	if(_rhs.EqualsZero())
+	{
+		result.m_divisionStatus = DecimalStatus::Error_DividedByZero;
+		return result;
+	}
+
+	// (a * B^z) / (b * B^z) has the quotient of a / b and the remainder of it times B^z.
+	const std::size_t zeroLimbs = std::min(m_zeroLimbs, _rhs.m_zeroLimbs);
+
+	kernels::Limbs quotient;
+	kernels::Limbs remainder;
+	kernels::DivRem(ToLimbs(*this, zeroLimbs), ToLimbs(_rhs, zeroLimbs), quotient, remainder);
+
+	result.Quotient.AssignLimbs(quotient);
+	result.Remainder.AssignLimbs(remainder, zeroLimbs);
+
+	return result;
+}
@@ -0,0 +1,527 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <Decimal.h>
+
+#include "DecimalIntegerDivisionResult.h"
+#include "DecimalCharConv.h"
+#include "DecimalReceiptPipeline.h"
+#include "DecimalSort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Decimal_VLN_BCD_bench - micro and macro benchmarks.
+ *
+ * Usage:
+ *   Decimal_VLN_BCD_bench [--filter <substring>] [--max-digits <n>] [--min-time <seconds>] [--json <file>]
+ *   Decimal_VLN_BCD_bench --compare <baseline.json> <current.json> [--threshold <percent>]
+ *
+ * The compare mode prints the time ratio of every benchmark present in both runs and exits with 1
+ * if any of them is slower than the threshold (10% by default).
+ */
+
+namespace
+{
+	struct Measurement
+	{
+		std::string m_name;
+		std::size_t m_digits = 0;
+		std::uint64_t m_iterations = 0;
+		double m_nanoseconds = 0;
+	};
+
+	struct Options
+	{
+		std::string m_filter;
+		std::size_t m_maxDigits = 1000000;
+		double m_minTime = 0.2;
+		std::string m_json;
+	};
+
+	// Results are folded in here, so that the measured operations are not optimized away.
+	volatile std::size_t g_sink = 0;
+
+	void Consume(const sav::Decimal& _value)
+	{
+		g_sink = g_sink + _value.EqualsZero();
+	}
+
+	// Deterministic base10 text with exactly _digits digits.
+	std::string Text(std::size_t _digits, std::uint64_t _seed)
+	{
+		std::string result;
+		result.reserve(_digits);
+
+		std::uint64_t state = _seed;
+		for(std::size_t i = 0; i < _digits; i++)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			char digit = static_cast<char>('0' + (state >> 33) % 10);
+			result.push_back(i == 0 && digit == '0' ? '1' : digit);
+		}
+
+		return result;
+	}
+
+	sav::Decimal Operand(std::size_t _digits, std::uint64_t _seed)
+	{
+		return sav::Decimal{Text(_digits, _seed)};
+	}
+
+	/**
+	 * Measure - run the operation in batches, growing the batch until it takes at least the minimum time.
+	 * @return time per operation of the last batch
+	 */
+	template<typename Operation>
+	Measurement Measure(const std::string& _name, std::size_t _digits, const Options& _options, Operation&& _operation)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::uint64_t iterations = 1;
+		for(;;)
+		{
+			auto start = Clock::now();
+			for(std::uint64_t i = 0; i < iterations; i++)
+			{
+				_operation();
+			}
+			double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+			if(elapsed >= _options.m_minTime || iterations >= (std::uint64_t{1} << 40))
+			{
+				return Measurement{_name, _digits, iterations, elapsed * 1e9 / static_cast<double>(iterations)};
+			}
+
+			// Aim at the minimum time directly, growing at most tenfold per batch.
+			double target = static_cast<double>(iterations) * _options.m_minTime * 1.2 / std::max(elapsed, 1e-9);
+			iterations = static_cast<std::uint64_t>(std::min(std::max(target, 2.0 * iterations), 10.0 * iterations));
+		}
+	}
+
+	class Suite
+	{
+		public:
+			explicit Suite(const Options& _options)
+				:	m_options(_options)
+			{
+
+			}
+
+			template<typename Operation>
+			void Run(const std::string& _name, std::size_t _digits, Operation&& _operation)
+			{
+				if(!m_options.m_filter.empty() && _name.find(m_options.m_filter) == std::string::npos)
+				{
+					return;
+				}
+
+				m_results.push_back(Measure(_name, _digits, m_options, std::forward<Operation>(_operation)));
+
+				const auto& result = m_results.back();
+				std::printf("%-28s %9zu %12llu %16.1f\n", result.m_name.c_str(), result.m_digits,
+					static_cast<unsigned long long>(result.m_iterations), result.m_nanoseconds);
+				std::fflush(stdout);
+			}
+
+			const std::vector<Measurement>& Results() const
+			{
+				return m_results;
+			}
+
+		protected:
+			const Options& m_options;
+
+			std::vector<Measurement> m_results;
+	};
+
+	void RunMicrobenchmarks(Suite& _suite, const Options& _options)
+	{
+		_suite.Run("Construct/UInt", 10, []()
+		{
+			Consume(sav::Decimal{4000000000u});
+		});
+
+		_suite.Run("Construct/UInt64", 20, []()
+		{
+			Consume(sav::Decimal{18000000000000000000ull});
+		});
+
+		const sav::Decimal kNative{18000000000000000000ull};
+		_suite.Run("ToUInt64", 20, [&]()
+		{
+			g_sink = g_sink + kNative.ToUInt64().value_or(0);
+		});
+
+		// 19 digits fill one 64-bit limb, then every decade up to a million digits.
+		for(std::size_t digits : {19, 100, 1000, 10000, 100000, 1000000})
+		{
+			if(digits > _options.m_maxDigits)
+			{
+				break;
+			}
+
+			const auto text = Text(digits, digits);
+			const auto lhs = Operand(digits, digits + 1);
+			const auto rhs = Operand(digits, digits + 2);
+			const auto sum = lhs + rhs;
+			const auto dividend = Operand(2 * digits, digits + 3);
+			const auto lhsCopy = sav::Decimal{lhs.ToString()};
+			const sav::Decimal k120{120};
+
+			_suite.Run("Construct/Copy", digits, [&]()
+			{
+				sav::Decimal copy{lhs};
+				Consume(copy);
+			});
+
+			_suite.Run("SetFromString", digits, [&]()
+			{
+				sav::Decimal value;
+				value.SetFromString(text);
+				Consume(value);
+			});
+
+			// One-shot conversion, next to the repeated formatting served from the text cache.
+			_suite.Run("ToString", digits, [&]()
+			{
+				g_sink = g_sink + lhs.ToString().size();
+			});
+
+			_suite.Run("ToString/Cached", digits, [&]()
+			{
+				g_sink = g_sink + lhs.ToCachedString().size();
+			});
+
+			_suite.Run("Add", digits, [&]()
+			{
+				Consume(lhs + rhs);
+			});
+
+			_suite.Run("Sub", digits, [&]()
+			{
+				Consume(sum - rhs);
+			});
+
+			_suite.Run("Mul", digits, [&]()
+			{
+				Consume(lhs * rhs);
+			});
+
+			_suite.Run("Div", digits, [&]()
+			{
+				Consume((dividend / lhs).Quotient);
+			});
+
+			// Amounts divided by a VAT-like divisor, as in VATTests.
+			_suite.Run("DivideAndRoundInBase10", digits, [&]()
+			{
+				Consume(lhs.DivideAndRoundInBase10(k120));
+			});
+
+			// Rounding decided from the remainder of a wide division.
+			_suite.Run("DivideAndRound/Wide", digits, [&]()
+			{
+				Consume(dividend.DivideAndRound(lhs, sav::DecimalRoundingMode::HalfEven));
+			});
+
+			_suite.Run("Compare/Less", digits, [&]()
+			{
+				g_sink = g_sink + (lhs < rhs);
+			});
+
+			// Distinct buffers with equal digits, so that the whole value is scanned.
+			_suite.Run("Compare/Equal", digits, [&]()
+			{
+				g_sink = g_sink + (lhs == lhsCopy);
+			});
+
+			// One limb of significant digits scaled up to the size, the rest are (implicit) zero limbs.
+			const auto scale = sav::Decimal::Pow2(static_cast<std::uint64_t>(digits * 3.32));
+			const auto scaledLhs = Operand(19, digits + 4) * scale;
+			const auto scaledRhs = Operand(19, digits + 5) * scale;
+
+			_suite.Run("Add/Scaled", digits, [&]()
+			{
+				Consume(scaledLhs + scaledRhs);
+			});
+
+			_suite.Run("Mul/Scaled", digits, [&]()
+			{
+				Consume(scaledLhs * scaledRhs);
+			});
+		}
+	}
+
+	// A receipt modelled on VATTests : VAT 20% included in every position, rounded per position.
+	void RunMacrobenchmarks(Suite& _suite)
+	{
+		constexpr std::size_t kPositions = 100;
+
+		std::vector<std::pair<sav::Decimal, sav::Decimal>> positions;
+		std::uint64_t state = 2019;
+		for(std::size_t i = 0; i < kPositions; i++)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			// Price in copecks up to 100000 roubles, quantity 1..10
+			positions.emplace_back(sav::Decimal{static_cast<unsigned int>(1 + (state >> 33) % 10000000)},
+				sav::Decimal{static_cast<unsigned int>(1 + (state >> 13) % 10)});
+		}
+
+		const sav::Decimal k20{20};
+		const sav::Decimal k120{120};
+
+		_suite.Run("VATReceipt", kPositions, [&]()
+		{
+			sav::Decimal total;
+			sav::Decimal vat;
+
+			for(const auto& position : positions)
+			{
+				sav::Decimal amount = position.first * position.second;
+				vat += (amount * k20).DivideAndRoundInBase10(k120);
+				total += amount;
+			}
+
+			Consume(total);
+			Consume(vat);
+		});
+
+		// The same positions as receipt text through the staged pipeline, ten positions per receipt.
+		constexpr std::size_t kReceipts = 1000;
+
+		std::string receipts;
+		for(std::size_t i = 0; i < kReceipts * 10; i++)
+		{
+			const auto& position = positions[i % kPositions];
+			receipts += (position.first * position.second).ToString() + (i % 10 == 9 ? "\n" : ",");
+		}
+
+		for(std::size_t threads : {1, 4})
+		{
+			sav::DecimalReceiptPipeline::Options options;
+			options.ComputeThreads = threads;
+			sav::DecimalReceiptPipeline pipeline{options};
+
+			_suite.Run("VATReceiptPipeline/" + std::to_string(threads), kReceipts, [&]()
+			{
+				std::istringstream input{receipts};
+				std::ostringstream output;
+				g_sink = g_sink + static_cast<std::size_t>(pipeline.Run(input, output));
+			});
+		}
+
+		// Receipt amounts of a day, many of them repeated; every run sorts (or dedupes) a fresh copy.
+		constexpr std::size_t kAmounts = 100000;
+
+		std::vector<sav::Decimal> amounts;
+		amounts.reserve(kAmounts);
+		for(std::size_t i = 0; i < kAmounts; i++)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			amounts.emplace_back(1 + (state >> 33) % 1000000);
+		}
+
+		_suite.Run("Sort/Compare", kAmounts, [&]()
+		{
+			auto values = amounts;
+			std::sort(values.begin(), values.end());
+			Consume(values.front());
+		});
+
+		_suite.Run("Sort/Radix", kAmounts, [&]()
+		{
+			auto values = amounts;
+			sav::RadixSort(values);
+			Consume(values.front());
+		});
+
+		_suite.Run("Dedupe", kAmounts, [&]()
+		{
+			auto values = amounts;
+			sav::Dedupe(values);
+			Consume(values.front());
+		});
+	}
+
+	bool WriteJson(const std::string& _path, const std::vector<Measurement>& _results)
+	{
+		std::ofstream file{_path};
+
+		// One benchmark per line, which is what ReadJson expects.
+		file << "{\n\t\"benchmarks\": [\n";
+		for(std::size_t i = 0; i < _results.size(); i++)
+		{
+			const auto& result = _results[i];
+			file << "\t\t{\"name\": \"" << result.m_name << "\", \"digits\": " << result.m_digits
+				<< ", \"iterations\": " << result.m_iterations << ", \"ns_per_op\": " << std::to_string(result.m_nanoseconds)
+				<< "}" << (i + 1 == _results.size() ? "" : ",") << "\n";
+		}
+		file << "\t]\n}\n";
+
+		return static_cast<bool>(file);
+	}
+
+	// Value of "_key": in a line written by WriteJson.
+	std::string Field(const std::string& _line, const std::string& _key)
+	{
+		auto position = _line.find("\"" + _key + "\": ");
+		if(position == std::string::npos)
+		{
+			return std::string{};
+		}
+
+		position += _key.size() + 4;
+		if(_line[position] == '"')
+		{
+			return _line.substr(position + 1, _line.find('"', position + 1) - position - 1);
+		}
+
+		return _line.substr(position, _line.find_first_of(",}", position) - position);
+	}
+
+	bool ReadJson(const std::string& _path, std::map<std::pair<std::string, std::size_t>, double>& _results)
+	{
+		std::ifstream file{_path};
+		if(!file)
+		{
+			return false;
+		}
+
+		std::string line;
+		while(std::getline(file, line))
+		{
+			auto name = Field(line, "name");
+			if(!name.empty())
+			{
+				_results[{name, std::stoull(Field(line, "digits"))}] = std::stod(Field(line, "ns_per_op"));
+			}
+		}
+
+		return true;
+	}
+
+	int Compare(const std::string& _baseline, const std::string& _current, double _threshold)
+	{
+		std::map<std::pair<std::string, std::size_t>, double> baseline;
+		std::map<std::pair<std::string, std::size_t>, double> current;
+		if(!ReadJson(_baseline, baseline) || !ReadJson(_current, current))
+		{
+			std::cerr << "Unable to read " << _baseline << " or " << _current << std::endl;
+			return 2;
+		}
+
+		int regressions = 0;
+		std::printf("%-28s %9s %16s %16s %9s\n", "benchmark", "digits", "baseline ns", "current ns", "change");
+		for(const auto& entry : current)
+		{
+			auto reference = baseline.find(entry.first);
+			if(reference == baseline.end())
+			{
+				continue;
+			}
+
+			double change = (entry.second / reference->second - 1.0) * 100.0;
+			bool regression = change > _threshold;
+			regressions += regression;
+
+			std::printf("%-28s %9zu %16.1f %16.1f %+8.1f%%%s\n", entry.first.first.c_str(), entry.first.second,
+				reference->second, entry.second, change, regression ? "  REGRESSION" : "");
+		}
+
+		return regressions == 0 ? 0 : 1;
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	Options options;
+	std::vector<std::string> compare;
+	double threshold = 10.0;
+
+	for(int i = 1; i < _argc; i++)
+	{
+		std::string argument = _argv[i];
+		bool hasValue = i + 1 < _argc;
+
+		if(argument == "--filter" && hasValue)
+		{
+			options.m_filter = _argv[++i];
+		}
+		else if(argument == "--max-digits" && hasValue)
+		{
+			options.m_maxDigits = std::stoull(_argv[++i]);
+		}
+		else if(argument == "--min-time" && hasValue)
+		{
+			options.m_minTime = std::stod(_argv[++i]);
+		}
+		else if(argument == "--json" && hasValue)
+		{
+			options.m_json = _argv[++i];
+		}
+		else if(argument == "--threshold" && hasValue)
+		{
+			threshold = std::stod(_argv[++i]);
+		}
+		else if(argument == "--compare" && i + 2 < _argc)
+		{
+			compare = {_argv[i + 1], _argv[i + 2]};
+			i += 2;
+		}
+		else
+		{
+			std::cerr << "Usage: " << _argv[0] << " [--filter <substring>] [--max-digits <n>] [--min-time <seconds>] [--json <file>]\n"
+				<< "       " << _argv[0] << " --compare <baseline.json> <current.json> [--threshold <percent>]" << std::endl;
+			return 2;
+		}
+	}
+
+	if(!compare.empty())
+	{
+		return Compare(compare[0], compare[1], threshold);
+	}
+
+	std::printf("%-28s %9s %12s %16s\n", "benchmark", "digits", "iterations", "ns/op");
+
+	Suite suite{options};
+	RunMicrobenchmarks(suite, options);
+	RunMacrobenchmarks(suite);
+
+	if(!options.m_json.empty() && !WriteJson(options.m_json, suite.Results()))
+	{
+		std::cerr << "Unable to write " << options.m_json << std::endl;
+		return 2;
+	}
+
+	return 0;
+}
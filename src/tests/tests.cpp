@@ -23,11 +23,36 @@
 #include <Decimal.h>
 
 #include "DecimalIntegerDivisionResult.h"
+#include "DecimalExtendedGcdResult.h"
+#include "DecimalAccumulator.h"
+#include "DecimalConcurrentAccumulator.h"
+#include "DecimalDotProduct.h"
+#include "DecimalSort.h"
+#include "DecimalMontgomeryContext.h"
+#include "DecimalView.h"
+#include "DecimalColumnWriter.h"
+#include "DecimalColumnReader.h"
+#include "DecimalStreamParser.h"
+#include "DecimalBoundedQueue.h"
+#include "DecimalReceiptPipeline.h"
+#include "DecimalCharConv.h"
+#include "DecimalInstrumentation.h"
+#include "DecimalThresholds.h"
+
+#include "../DecimalKernels.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <atomic>
 #include <iostream>
+#include <functional>
+#include <unordered_set>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <cstdio>
 
 class DecimalTestWrapper
 	:	public sav::Decimal
@@ -233,6 +258,327 @@ TEST_F(ArithmeticTests, DivideBinaryGreaterByBinaryExp1WithoutRemainder)
 	ASSERT_EQ(result.Remainder, sav::Decimal{std::to_string(divident % divisor)});
 }
 
+TEST(SmallValueTests, LimbBoundaries)
+{
+	const sav::Decimal kMax{std::numeric_limits<std::uint64_t>::max()};
+	const sav::Decimal k1{1};
+	const sav::Decimal k2{2};
+
+	// carries and overflows leave the single-limb fast paths for the general ones
+	ASSERT_EQ(kMax + k1, sav::Decimal::Pow2(64));
+	ASSERT_EQ((kMax + kMax).ToString(), "36893488147419103230");
+	ASSERT_EQ(sav::Decimal::Pow2(64) - k1, kMax);
+	ASSERT_FALSE(k1 - k2);
+
+	ASSERT_EQ((sav::Decimal{0xFFFFFFFFu} * sav::Decimal{0xFFFFFFFFu}).ToString(), "18446744065119617025");
+	ASSERT_EQ((sav::Decimal{0x100000000u} * sav::Decimal{0xFFFFFFFFu}).ToString(), "18446744069414584320");
+	ASSERT_EQ((kMax * kMax).ToString(), "340282366920938463426481119284349108225");
+
+	ASSERT_TRUE(kMax < sav::Decimal::Pow2(64));
+	ASSERT_TRUE(sav::Decimal::Pow2(64) > kMax);
+	ASSERT_TRUE(k2 <= k2 && k2 >= k2);
+	ASSERT_FALSE(k1 >= k2);
+
+	auto division = kMax / sav::Decimal{10};
+	ASSERT_TRUE(division);
+	ASSERT_EQ(division.Quotient.ToString(), "1844674407370955161");
+	ASSERT_EQ(division.Remainder.ToString(), "5");
+
+	// max / 2 == 9223372036854775807.5 : the odd quotient is rounded up to the even one
+	ASSERT_EQ(kMax.DivideAndRound(k2, sav::DecimalRoundingMode::HalfEven).ToString(), "9223372036854775808");
+	ASSERT_EQ(kMax.DivideAndRound(k2, sav::DecimalRoundingMode::HalfDown).ToString(), "9223372036854775807");
+	ASSERT_EQ(kMax.DivideAndRound(k1, sav::DecimalRoundingMode::Ceiling), kMax);
+	ASSERT_EQ(kMax.DivideAndRound(kMax, sav::DecimalRoundingMode::HalfUp), k1);
+}
+
+class LargeNumberTests
+	:	public ::testing::Test
+{
+public:
+	// Deterministic pseudo-random number with exactly _digits base256 digits.
+	sav::Decimal Random(int _digits)
+	{
+		sav::Decimal result{1 + Next() % 255};
+
+		for(int i = 1; i < _digits; i++)
+		{
+			result = result * sav::Decimal{256} + sav::Decimal{Next() % 256};
+		}
+
+		return result;
+	}
+
+	unsigned int Next()
+	{
+		m_state = m_state * 6364136223846793005ull + 1442695040888963407ull;
+		return static_cast<unsigned int>(m_state >> 33);
+	}
+
+	std::uint64_t m_state = 2019;
+};
+
+TEST_F(LargeNumberTests, MultiplicationMatchesDotProduct)
+{
+	for(int digits : {1, 7, 100, 300, 1000, 2500})
+	{
+		auto lhs = Random(digits);
+		auto rhs = Random(digits / 2 + 1);
+
+		ASSERT_EQ(lhs * rhs, sav::DotProduct(std::vector<sav::Decimal>{lhs}, std::vector<sav::Decimal>{rhs}));
+		ASSERT_EQ(lhs * rhs, rhs * lhs);
+	}
+}
+
+TEST_F(LargeNumberTests, DivisionRestoresQuotientAndRemainder)
+{
+	for(auto sizes : std::vector<std::pair<int, int>>{{2, 2}, {40, 9}, {200, 100}, {1200, 400}, {3000, 500}, {4000, 2000}})
+	{
+		auto divisor = Random(sizes.second);
+		auto quotient = Random(sizes.first);
+		auto remainder = Random(sizes.second - 1);
+
+		auto result = (divisor * quotient + remainder) / divisor;
+		ASSERT_TRUE(result);
+		ASSERT_EQ(result.Quotient, quotient);
+		ASSERT_EQ(result.Remainder, remainder);
+	}
+}
+
+TEST_F(LargeNumberTests, ExactDivision)
+{
+	for(auto sizes : std::vector<std::pair<int, int>>{{1, 1}, {3, 9}, {100, 1}, {200, 100}, {1000, 700}})
+	{
+		auto divisor = Random(sizes.second);
+		auto quotient = Random(sizes.first);
+
+		ASSERT_EQ((divisor * quotient).DivExact(divisor), quotient);
+
+		// with a power of two in the divisor
+		auto evenDivisor = divisor * sav::Decimal{1u << 20};
+		ASSERT_EQ((evenDivisor * quotient).DivExact(evenDivisor), quotient);
+	}
+
+	ASSERT_TRUE(sav::Decimal{"0"}.DivExact(sav::Decimal{"3"}).EqualsZero());
+	ASSERT_FALSE(sav::Decimal{"3"}.DivExact(sav::Decimal{"0"}));
+
+#ifndef NDEBUG
+	ASSERT_FALSE(sav::Decimal{"10"}.DivExact(sav::Decimal{"3"}));
+#endif
+}
+
+TEST_F(LargeNumberTests, MontgomeryMatchesDivision)
+{
+	auto modulus = Random(300) * sav::Decimal{2} + sav::Decimal{1};
+	sav::DecimalMontgomeryContext context{modulus};
+	ASSERT_TRUE(context);
+
+	auto lhs = Random(400);
+	auto rhs = Random(250);
+
+	ASSERT_EQ(context.MulMod(lhs, rhs), (lhs * rhs / modulus).Remainder);
+	ASSERT_EQ(context.FromMontgomery(context.ToMontgomery(rhs)), rhs);
+
+	// lhs ^ 300 by repeated multiplication
+	auto expected = sav::Decimal{1};
+	for(int i = 0; i < 300; i++)
+	{
+		expected = (expected * lhs / modulus).Remainder;
+	}
+
+	ASSERT_EQ(context.PowMod(lhs, sav::Decimal{300}), expected);
+}
+
+TEST(MontgomeryTests, PowMod)
+{
+	sav::DecimalMontgomeryContext context{sav::Decimal{"497"}};
+	ASSERT_EQ(context.PowMod(sav::Decimal{"4"}, sav::Decimal{"13"}).ToString(), "445");
+	ASSERT_EQ(context.PowMod(sav::Decimal{"4"}, sav::Decimal{"0"}).ToString(), "1");
+
+	// Fermat's little theorem for the Mersenne prime 2^127 - 1
+	sav::Decimal prime{"170141183460469231731687303715884105727"};
+	sav::DecimalMontgomeryContext primeContext{prime};
+	auto exponent = prime;
+	exponent--;
+	ASSERT_EQ(primeContext.PowMod(sav::Decimal{"123456789"}, exponent).ToString(), "1");
+
+	ASSERT_FALSE(sav::DecimalMontgomeryContext{sav::Decimal{"100"}});
+	ASSERT_FALSE(context.PowMod(sav::Decimal{"0"} - sav::Decimal{"1"}, sav::Decimal{"2"}));
+}
+
+TEST_F(LargeNumberTests, GcdOfLargeNumbers)
+{
+	for(auto sizes : std::vector<std::pair<int, int>>{{1, 1}, {5, 20}, {100, 3}, {300, 280}, {700, 500}})
+	{
+		auto common = Random(sizes.first % 50 + 1);
+		auto lhs = Random(sizes.first) * common;
+		auto rhs = Random(sizes.second) * common;
+
+		auto gcd = sav::Decimal::Gcd(lhs, rhs);
+		ASSERT_TRUE((lhs / gcd).Remainder.EqualsZero());
+		ASSERT_TRUE((rhs / gcd).Remainder.EqualsZero());
+		ASSERT_TRUE((common / gcd).Remainder.EqualsZero() || (gcd / common).Remainder.EqualsZero());
+
+		// Cofactors of the GCD are coprime
+		ASSERT_EQ(sav::Decimal::Gcd(lhs.DivExact(gcd), rhs.DivExact(gcd)), sav::Decimal{1});
+
+		auto extended = sav::Decimal::ExtendedGcd(lhs, rhs);
+		ASSERT_TRUE(extended);
+		ASSERT_EQ(extended.Gcd, gcd);
+		if(extended.CoefficientANegative)
+		{
+			ASSERT_EQ(rhs * extended.CoefficientB, lhs * extended.CoefficientA + gcd);
+		}
+		else
+		{
+			ASSERT_EQ(lhs * extended.CoefficientA, rhs * extended.CoefficientB + gcd);
+		}
+
+		ASSERT_EQ(sav::Decimal::Lcm(lhs, rhs) * gcd, lhs * rhs);
+	}
+
+	// b divides a (or a is zero): X == 0, Y == 1 and the gcd is wider than a * X
+	const sav::Decimal wide{"340282366920938463463374607431768211507"};
+	for(const auto& lhs : {wide * sav::Decimal{3}, wide * Random(40), sav::Decimal{0}})
+	{
+		auto extended = sav::Decimal::ExtendedGcd(lhs, wide);
+		ASSERT_TRUE(extended);
+		ASSERT_EQ(extended.Gcd, wide);
+		ASSERT_TRUE(extended.CoefficientA.EqualsZero());
+		ASSERT_EQ(extended.CoefficientB, sav::Decimal{1});
+	}
+}
+
+TEST(GcdTests, SmallValues)
+{
+	ASSERT_EQ(sav::Decimal::Gcd(sav::Decimal{"12"}, sav::Decimal{"18"}).ToString(), "6");
+	ASSERT_EQ(sav::Decimal::Gcd(sav::Decimal{"0"}, sav::Decimal{"18"}).ToString(), "18");
+	ASSERT_EQ(sav::Decimal::Gcd(sav::Decimal{"0"}, sav::Decimal{"0"}).ToString(), "0");
+	ASSERT_EQ(sav::Decimal::Lcm(sav::Decimal{"4"}, sav::Decimal{"6"}).ToString(), "12");
+	ASSERT_EQ(sav::Decimal::Lcm(sav::Decimal{"4"}, sav::Decimal{"0"}).ToString(), "0");
+
+	// 240 * (-9) + 46 * 47 == 2
+	auto extended = sav::Decimal::ExtendedGcd(sav::Decimal{"240"}, sav::Decimal{"46"});
+	ASSERT_EQ(extended.Gcd.ToString(), "2");
+	ASSERT_TRUE(extended.CoefficientANegative);
+	ASSERT_EQ(extended.CoefficientA.ToString(), "9");
+	ASSERT_EQ(extended.CoefficientB.ToString(), "47");
+
+	// 10 is a multiple of 5: 5 * 1 - 10 * 0 == 5
+	auto multiple = sav::Decimal::ExtendedGcd(sav::Decimal{"10"}, sav::Decimal{"5"});
+	ASSERT_EQ(multiple.Gcd.ToString(), "5");
+	ASSERT_TRUE(multiple.CoefficientANegative);
+	ASSERT_TRUE(multiple.CoefficientA.EqualsZero());
+	ASSERT_EQ(multiple.CoefficientB.ToString(), "1");
+}
+
+TEST_F(LargeNumberTests, SquareAndPower)
+{
+	for(int digits : {1, 8, 9, 100, 255, 256, 257, 1000, 3000})
+	{
+		auto value = Random(digits);
+		ASSERT_EQ(value.Square(), value * value);
+	}
+
+	auto base = Random(20);
+	auto expected = sav::Decimal{1};
+	for(std::uint64_t exponent = 0; exponent < 40; exponent++)
+	{
+		ASSERT_EQ(base.Pow(exponent), expected);
+		expected *= base;
+	}
+}
+
+TEST_F(LargeNumberTests, AdditionAndSubtractionCarryChains)
+{
+	// 2^n - 1 + 1 carries through every limb, 2^n - 1 borrows through every limb
+	for(std::uint64_t bits : {8, 64, 128, 192, 256, 320, 4096})
+	{
+		auto power = sav::Decimal::Pow2(bits);
+		auto allOnes = power - sav::Decimal{1};
+
+		ASSERT_EQ(allOnes + sav::Decimal{1}, power);
+		ASSERT_EQ(sav::Decimal{1} + allOnes, power);
+		ASSERT_EQ(power - allOnes, sav::Decimal{1});
+		ASSERT_EQ(allOnes + allOnes, power + power - sav::Decimal{2});
+	}
+
+	for(int digits : {1, 7, 8, 9, 31, 32, 33, 100, 1000})
+	{
+		auto lhs = Random(digits);
+		auto rhs = Random(digits / 2 + 1);
+
+		ASSERT_EQ(lhs + rhs - rhs, lhs);
+		ASSERT_EQ(lhs + rhs, rhs + lhs);
+		ASSERT_EQ((lhs + rhs) - lhs, rhs);
+		ASSERT_FALSE(rhs - (lhs + rhs));
+	}
+}
+
+TEST_F(LargeNumberTests, ScaledValues)
+{
+	// 40 zero limbs below the significant digits
+	auto scale = sav::Decimal::Pow2(64 * 40);
+	auto value = Random(20);
+	auto scaled = value * scale;
+
+	// the same value parsed from text or built otherwise compares equal
+	ASSERT_EQ(scaled, sav::Decimal{scaled.ToString()});
+	ASSERT_EQ(scaled, scale * value);
+	ASSERT_EQ(scale, sav::Decimal{2}.Pow(64 * 40));
+
+	ASSERT_EQ(scaled + value - value, scaled);
+	ASSERT_EQ(scaled + scaled, value * sav::Decimal::Pow2(64 * 40 + 1));
+	ASSERT_EQ((scaled + value) - scaled, value);
+	ASSERT_FALSE(value - scaled);
+
+	ASSERT_TRUE(value < scaled);
+	ASSERT_TRUE(scaled < scaled + sav::Decimal{1});
+	ASSERT_TRUE(scaled * sav::Decimal{2} > scaled + value);
+
+	auto division = (scaled + sav::Decimal{7}) / scale;
+	ASSERT_EQ(division.Quotient, value);
+	ASSERT_EQ(division.Remainder.ToString(), "7");
+	division = (scaled + scale) / (value * sav::Decimal::Pow2(64 * 3));
+	ASSERT_EQ(division.Quotient * value * sav::Decimal::Pow2(64 * 3) + division.Remainder, scaled + scale);
+
+	ASSERT_EQ(scaled.Square(), value.Square() * scale.Square());
+
+	auto incremented = scaled;
+	incremented++;
+	ASSERT_EQ(incremented, scaled + sav::Decimal{1});
+	incremented--;
+	incremented--;
+	ASSERT_EQ(incremented + sav::Decimal{1}, scaled);
+
+	std::vector<std::uint8_t> buffer;
+	scaled.Serialize(buffer);
+	ASSERT_EQ(buffer.size(), scaled.SerializedSize());
+
+	sav::Decimal deserialized;
+	ASSERT_EQ(deserialized.Deserialize(buffer.data(), buffer.size()), sav::DecimalStatus::Ok);
+	ASSERT_EQ(deserialized, scaled);
+
+	sav::DecimalAccumulator accumulator;
+	accumulator.Add(scaled);
+	accumulator.AddProduct(value, scale);
+	ASSERT_EQ(accumulator.Value(), scaled + scaled);
+}
+
+TEST(PowerTests, PowersOfTenAndTwo)
+{
+	ASSERT_EQ(sav::Decimal::Pow10(0).ToString(), "1");
+	ASSERT_EQ(sav::Decimal::Pow10(1).ToString(), "10");
+	ASSERT_EQ(sav::Decimal::Pow10(30).ToString(), "1" + std::string(30, '0'));
+	ASSERT_EQ(sav::Decimal::Pow10(100), sav::Decimal{10}.Pow(100));
+
+	ASSERT_EQ(sav::Decimal::Pow2(0).ToString(), "1");
+	ASSERT_EQ(sav::Decimal::Pow2(64).ToString(), "18446744073709551616");
+	ASSERT_EQ(sav::Decimal::Pow2(1000), sav::Decimal{2}.Pow(1000));
+
+	// 1.05^2 in hundredths
+	ASSERT_EQ(sav::Decimal{"105"}.Pow(2).ToString(), "11025");
+}
+
 class VATTests
 	:	public ::testing::Test
 {
@@ -308,6 +654,1154 @@ TEST_F(VATTests, CalculateVATForEntireTwoPositions)
 	}
 }
 
+TEST(RoundingTests, AllModes)
+{
+	using sav::DecimalRoundingMode;
+
+	struct Case
+	{
+		unsigned int Dividend;
+		unsigned int Divisor;
+		DecimalRoundingMode Mode;
+		const char* Expected;
+	};
+
+	// 2.5, 3.5, 2.6, 2.4, 2.0 and 0
+	std::vector<Case> cases = {
+		{25, 10, DecimalRoundingMode::HalfUp, "3"},
+		{25, 10, DecimalRoundingMode::HalfEven, "2"},
+		{35, 10, DecimalRoundingMode::HalfEven, "4"},
+		{25, 10, DecimalRoundingMode::HalfDown, "2"},
+		{25, 10, DecimalRoundingMode::Ceiling, "3"},
+		{25, 10, DecimalRoundingMode::Floor, "2"},
+		{25, 10, DecimalRoundingMode::Truncate, "2"},
+		{26, 10, DecimalRoundingMode::HalfDown, "3"},
+		{26, 10, DecimalRoundingMode::HalfEven, "3"},
+		{24, 10, DecimalRoundingMode::HalfUp, "2"},
+		{21, 10, DecimalRoundingMode::Ceiling, "3"},
+		{20, 10, DecimalRoundingMode::Ceiling, "2"},
+		{20, 10, DecimalRoundingMode::HalfUp, "2"},
+		{0, 7, DecimalRoundingMode::Ceiling, "0"},
+		// 0.5 : the even neighbour is zero
+		{1, 2, DecimalRoundingMode::HalfEven, "0"},
+		{1, 2, DecimalRoundingMode::HalfUp, "1"},
+	};
+
+	for(auto& it : cases)
+	{
+		auto result = sav::Decimal{it.Dividend}.DivideAndRound(sav::Decimal{it.Divisor}, it.Mode);
+		ASSERT_TRUE(result);
+		ASSERT_EQ(result.ToString(), it.Expected);
+	}
+
+	ASSERT_FALSE(sav::Decimal{1}.DivideAndRound(sav::Decimal{}, DecimalRoundingMode::HalfUp));
+}
+
+TEST_F(LargeNumberTests, RoundingWithWideDivisors)
+{
+	const sav::Decimal k1{1};
+	const sav::Decimal k2{2};
+
+	for(int digits : {9, 40, 200, 700})
+	{
+		auto dividend = Random(2 * digits);
+		auto divisor = Random(digits);
+
+		// round half up (a / d) == floor((2a + d) / 2d), ceiling (a / d) == floor((a + d - 1) / d)
+		ASSERT_EQ(dividend.DivideAndRoundInBase10(divisor), ((k2 * dividend + divisor) / (k2 * divisor)).Quotient);
+		ASSERT_EQ(dividend.DivideAndRound(divisor, sav::DecimalRoundingMode::Ceiling), ((dividend + divisor - k1) / divisor).Quotient);
+		ASSERT_EQ(dividend.DivideAndRound(divisor, sav::DecimalRoundingMode::Truncate), (dividend / divisor).Quotient);
+
+		// exact ties: (2q + 1) * d / 2d == q + 1/2, for an even and an odd q
+		auto even = k2 * Random(digits);
+		auto odd = even + k1;
+		ASSERT_EQ(((k2 * even + k1) * divisor).DivideAndRound(k2 * divisor, sav::DecimalRoundingMode::HalfEven), even);
+		ASSERT_EQ(((k2 * odd + k1) * divisor).DivideAndRound(k2 * divisor, sav::DecimalRoundingMode::HalfEven), odd + k1);
+		ASSERT_EQ(((k2 * even + k1) * divisor).DivideAndRound(k2 * divisor, sav::DecimalRoundingMode::HalfUp), odd);
+		ASSERT_EQ(((k2 * odd + k1) * divisor).DivideAndRound(k2 * divisor, sav::DecimalRoundingMode::HalfDown), odd);
+	}
+}
+
+TEST(ConversionTests, NativeIntegers)
+{
+	const std::uint64_t kMax = std::numeric_limits<std::uint64_t>::max();
+
+	ASSERT_EQ(sav::Decimal{0}.ToUInt64(), std::uint64_t{0});
+	ASSERT_EQ(sav::Decimal{kMax}.ToString(), "18446744073709551615");
+	ASSERT_EQ(sav::Decimal{"18446744073709551615"}.ToUInt64(), kMax);
+	ASSERT_EQ(sav::Decimal{"4294967295"}.ToUInt(), std::numeric_limits<unsigned int>::max());
+	ASSERT_EQ(sav::Decimal{"4294967296"}.ToUInt(), std::nullopt);
+
+	// 2^64 is a single digit above an implicit zero limb
+	auto overflow = sav::Decimal{kMax} + sav::Decimal{1};
+	ASSERT_EQ(overflow.ToUInt64(), std::nullopt);
+	ASSERT_EQ(overflow.ToUInt64Saturated(), kMax);
+	ASSERT_EQ(sav::Decimal::Pow2(63).ToUInt64(), std::uint64_t{1} << 63);
+
+#ifdef __SIZEOF_INT128__
+	const unsigned __int128 kHigh = static_cast<unsigned __int128>(0x0123456789ABCDEFull) << 64;
+
+	ASSERT_EQ(sav::Decimal::FromUInt128(static_cast<unsigned __int128>(1) << 64), overflow);
+	ASSERT_EQ(sav::Decimal::FromUInt128(kHigh | 0xFEDCBA9876543210ull).ToString(), "1512366075204170947332355369683137040");
+	ASSERT_TRUE(sav::Decimal::FromUInt128(kHigh | 0xFEDCBA9876543210ull).ToUInt128() == (kHigh | 0xFEDCBA9876543210ull));
+	ASSERT_TRUE(sav::Decimal::FromUInt128(kHigh).ToUInt128() == kHigh);
+	ASSERT_TRUE(sav::Decimal::FromUInt128(0).EqualsZero());
+
+	ASSERT_FALSE(sav::Decimal::Pow2(128).ToUInt128().has_value());
+	ASSERT_TRUE(sav::Decimal::Pow2(128).ToUInt128Saturated() == ~static_cast<unsigned __int128>(0));
+	ASSERT_TRUE(sav::Decimal::Pow2(127).ToUInt128() == static_cast<unsigned __int128>(1) << 127);
+#endif
+}
+
+TEST(AccumulatorTests, SumOfNativeIntegers)
+{
+	sav::DecimalAccumulator accumulator;
+
+	for(std::uint64_t i = 1; i <= 100000; i++)
+	{
+		accumulator.Add(i);
+	}
+
+	auto result = accumulator.Value();
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result.ToString(), "5000050000");
+}
+
+TEST(AccumulatorTests, SumOfDecimalsAndBatches)
+{
+	sav::DecimalAccumulator accumulator{sav::Decimal{"65535"}};
+
+	accumulator += sav::Decimal{"1"};
+	accumulator += std::uint64_t{255};
+	accumulator.Add(std::vector<sav::Decimal>{sav::Decimal{"16777215"}, sav::Decimal{"1"}});
+	accumulator.Add(std::vector<std::uint64_t>{std::numeric_limits<std::uint64_t>::max(), 1});
+
+	// 65535 + 1 + 255 + 16777215 + 1 + (2^64 - 1) + 1
+	auto result = accumulator.Value();
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result.ToString(), "18446744073726394623");
+}
+
+TEST(AccumulatorTests, MergeAndReset)
+{
+	sav::DecimalAccumulator accumulator1;
+	sav::DecimalAccumulator accumulator2;
+
+	for(unsigned int i = 0; i < 1000; i++)
+	{
+		accumulator1 += sav::Decimal{255};
+		accumulator2 += sav::Decimal{1};
+	}
+
+	accumulator1.Add(accumulator2);
+	ASSERT_EQ(accumulator1.Value().ToString(), "256000");
+
+	accumulator1.Reset();
+	ASSERT_TRUE(accumulator1.Value().EqualsZero());
+}
+
+TEST(AccumulatorTests, ErrorStatusIsPropagated)
+{
+	sav::DecimalAccumulator accumulator;
+
+	accumulator += sav::Decimal{"1"};
+	accumulator += sav::Decimal{"0"} - sav::Decimal{"1"};
+
+	ASSERT_FALSE(accumulator);
+	ASSERT_FALSE(accumulator.Value());
+}
+
+TEST(ConcurrentAccumulatorTests, SumFromSeveralThreads)
+{
+	sav::DecimalConcurrentAccumulator accumulator{4};
+
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 8; i++)
+	{
+		threads.emplace_back([&accumulator]()
+		{
+			for(std::uint64_t j = 1; j <= 10000; j++)
+			{
+				accumulator.Add(j);
+				accumulator += sav::Decimal{255};
+			}
+		});
+	}
+
+	for(auto& it : threads)
+	{
+		it.join();
+	}
+
+	// 8 * (10000 * 10001 / 2 + 10000 * 255)
+	auto result = accumulator.Value();
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result.ToString(), "420440000");
+}
+
+TEST(ConcurrentAccumulatorTests, ColumnsWrap)
+{
+	// fewer shards than threads: wraps of a column are counted by whoever causes them
+	sav::DecimalConcurrentAccumulator accumulator{2};
+	const auto max = std::numeric_limits<std::uint64_t>::max();
+	const auto maxValue = sav::DecimalAccumulator{}.Add(max).Value();
+	// 2^128 - 1 = (2^64 - 1) * 2^64 + (2^64 - 1)
+	auto wide = maxValue;
+	for(int i = 0; i < std::numeric_limits<std::uint64_t>::digits; i++)
+	{
+		wide = wide + wide;
+	}
+	wide = wide + maxValue;
+
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 4; i++)
+	{
+		threads.emplace_back([&]()
+		{
+			for(int j = 0; j < 10000; j++)
+			{
+				accumulator += max;
+				accumulator += wide;
+			}
+		});
+	}
+
+	for(auto& it : threads)
+	{
+		it.join();
+	}
+
+	sav::DecimalAccumulator expected;
+	for(int j = 0; j < 40000; j++)
+	{
+		expected += max;
+		expected += wide;
+	}
+
+	ASSERT_EQ(accumulator.Value(), expected.Value());
+}
+
+TEST(ConcurrentAccumulatorTests, ValueWhileAdding)
+{
+	// writers never pause, so optimistic reads of a shard keep failing
+	sav::DecimalConcurrentAccumulator accumulator{2};
+	std::atomic<bool> stop{false};
+	std::atomic<std::uint64_t> added{0};
+
+	std::vector<std::thread> threads;
+	for(int i = 0; i < 8; i++)
+	{
+		threads.emplace_back([&]()
+		{
+			std::uint64_t count = 0;
+			while(!stop.load(std::memory_order_relaxed))
+			{
+				accumulator += 1;
+				count++;
+			}
+
+			added.fetch_add(count);
+		});
+	}
+
+	sav::Decimal previous;
+	for(int i = 0; i < 200; i++)
+	{
+		auto value = accumulator.Value();
+		ASSERT_GE(value, previous);
+		previous = value;
+	}
+
+	stop = true;
+	for(auto& it : threads)
+	{
+		it.join();
+	}
+
+	ASSERT_EQ(accumulator.Value(), sav::DecimalAccumulator{}.Add(added.load()).Value());
+}
+
+TEST(ConcurrentAccumulatorTests, AddendWiderThanShards)
+{
+	sav::DecimalConcurrentAccumulator accumulator{2, 8};
+
+	// 2^64 does not fit into 8 digits
+	auto wide = sav::DecimalAccumulator{}.Add(std::numeric_limits<std::uint64_t>::max()).Add(1).Value();
+
+	accumulator += std::numeric_limits<std::uint64_t>::max();
+	accumulator += sav::Decimal{1};
+	accumulator += wide;
+
+	ASSERT_EQ(accumulator.Value().ToString(), "36893488147419103232");
+
+	accumulator.Reset();
+	ASSERT_TRUE(accumulator.Value().EqualsZero());
+}
+
+TEST(DotProductTests, PricesByQuantities)
+{
+	std::vector<sav::Decimal> prices = {sav::Decimal{"10000"}, sav::Decimal{"255"}, sav::Decimal{"65536"}, sav::Decimal{"0"}};
+	std::vector<sav::Decimal> quantities = {sav::Decimal{"3"}, sav::Decimal{"257"}, sav::Decimal{"65535"}, sav::Decimal{"7"}};
+	std::vector<std::uint64_t> nativeQuantities = {3, 257, 65535, 7};
+
+	// 30000 + 65535 + 4294901760
+	auto result = sav::DotProduct(prices, quantities);
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result.ToString(), "4294997295");
+
+	auto nativeResult = sav::DotProduct(prices, nativeQuantities);
+	ASSERT_TRUE(nativeResult);
+	ASSERT_EQ(nativeResult, result);
+}
+
+TEST(DotProductTests, SizeMismatch)
+{
+	std::vector<sav::Decimal> prices = {sav::Decimal{"10000"}, sav::Decimal{"255"}};
+	std::vector<std::uint64_t> quantities = {3};
+
+	ASSERT_FALSE(sav::DotProduct(prices, quantities));
+	ASSERT_TRUE(sav::DotProduct(prices.data(), quantities.data(), quantities.size()));
+}
+
+TEST(ComparisonTests, DifferentDigitCounts)
+{
+	ASSERT_LT(sav::Decimal{255}, sav::Decimal{256});
+	ASSERT_GT(sav::Decimal{256}, sav::Decimal{255});
+	ASSERT_GT(sav::Decimal{65536}, sav::Decimal{1});
+	ASSERT_LE(sav::Decimal{0}, sav::Decimal{1});
+	ASSERT_FALSE(sav::Decimal{256} < sav::Decimal{255});
+}
+
+TEST_F(LargeNumberTests, SerializationRoundTrip)
+{
+	std::vector<sav::Decimal> values = {sav::Decimal{0}, sav::Decimal{1}, sav::Decimal{"1234567890"}, Random(127), Random(128), Random(1000)};
+
+	std::vector<std::uint8_t> buffer;
+	for(const auto& value : values)
+	{
+		auto before = buffer.size();
+		value.Serialize(buffer);
+		ASSERT_EQ(buffer.size() - before, value.SerializedSize());
+	}
+
+	// Zero is a single byte, 128 digits need a two-byte length
+	ASSERT_EQ(values[0].SerializedSize(), 1);
+	ASSERT_EQ(values[4].SerializedSize(), 130);
+
+	std::size_t offset = 0;
+	for(const auto& value : values)
+	{
+		sav::Decimal decoded;
+		ASSERT_EQ(decoded.Deserialize(buffer.data() + offset, buffer.size() - offset), sav::DecimalStatus::Ok);
+		ASSERT_EQ(decoded, value);
+
+		sav::DecimalView view;
+		auto consumed = sav::DecimalView::Parse(buffer.data() + offset, buffer.size() - offset, view);
+		ASSERT_EQ(consumed, value.SerializedSize());
+		ASSERT_EQ(view, value);
+		ASSERT_EQ(view.ToDecimal(), value);
+
+		offset += consumed;
+	}
+
+	ASSERT_EQ(offset, buffer.size());
+}
+
+TEST(SerializationTests, TruncatedInput)
+{
+	std::vector<std::uint8_t> buffer;
+	sav::Decimal{"1234567890"}.Serialize(buffer);
+
+	sav::Decimal decoded{7};
+	ASSERT_EQ(decoded.Deserialize(buffer.data(), buffer.size() - 1), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(decoded.Deserialize(buffer.data(), 0), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(decoded, sav::Decimal{7});
+
+	// Length continuation byte without the rest of the length
+	std::uint8_t unterminated[] = {0x80};
+	sav::DecimalView view;
+	ASSERT_EQ(sav::DecimalView::Parse(unterminated, sizeof(unterminated), view), 0);
+}
+
+TEST_F(LargeNumberTests, ViewArithmetic)
+{
+	auto lhs = Random(300);
+	auto rhs = Random(120);
+
+	std::vector<std::uint8_t> buffer;
+	lhs.Serialize(buffer);
+	rhs.Serialize(buffer);
+
+	sav::DecimalView lhsView;
+	sav::DecimalView rhsView;
+	auto consumed = sav::DecimalView::Parse(buffer.data(), buffer.size(), lhsView);
+	ASSERT_NE(sav::DecimalView::Parse(buffer.data() + consumed, buffer.size() - consumed, rhsView), 0);
+
+	ASSERT_GT(lhsView, rhsView);
+	ASSERT_EQ(lhsView + rhsView, lhs + rhs);
+	ASSERT_EQ(lhsView - rhsView, lhs - rhs);
+	ASSERT_FALSE(rhsView - lhsView);
+	ASSERT_EQ(lhsView * rhsView, lhs * rhs);
+
+	auto result = lhsView / rhsView;
+	ASSERT_TRUE(result);
+	ASSERT_EQ(result.Quotient, (lhs / rhs).Quotient);
+	ASSERT_EQ(result.Remainder, (lhs / rhs).Remainder);
+	ASSERT_FALSE(lhsView / sav::DecimalView{});
+}
+
+TEST_F(LargeNumberTests, ColumnFileRoundTrip)
+{
+	const std::string path = ::testing::TempDir() + "decimal_columns.bin";
+
+	std::vector<sav::Decimal> values;
+	for(int digits : {1, 4, 15, 16, 40, 1000})
+	{
+		values.push_back(Random(digits));
+	}
+	values.push_back(sav::Decimal{0});
+
+	{
+		sav::DecimalColumnWriter writer{path};
+		ASSERT_TRUE(writer);
+
+		for(const auto& value : values)
+		{
+			ASSERT_EQ(writer.Append(value), sav::DecimalStatus::Ok);
+		}
+
+		ASSERT_EQ(writer.Close(), sav::DecimalStatus::Ok);
+		ASSERT_EQ(writer.Count(), values.size());
+	}
+
+	sav::DecimalColumnReader reader{path};
+	ASSERT_TRUE(reader);
+	ASSERT_EQ(reader.Size(), values.size());
+
+	for(std::size_t i = 0; i < values.size(); i++)
+	{
+		ASSERT_EQ(reader[i], values[i]);
+		ASSERT_EQ(reader[i].ToDecimal(), values[i]);
+	}
+
+	sav::DecimalView view;
+	ASSERT_EQ(reader.At(values.size(), view), sav::DecimalStatus::Error_InvalidArgument);
+
+	std::remove(path.c_str());
+}
+
+TEST(ColumnFileTests, InvalidFiles)
+{
+	const std::string path = ::testing::TempDir() + "decimal_columns_invalid.bin";
+
+	ASSERT_EQ(sav::DecimalColumnReader{path + ".missing"}.Status(), sav::DecimalStatus::Error_IO);
+
+	{
+		std::ofstream file{path, std::ios::binary};
+		file << "not a column file, but long enough to hold a header of sixty-four bytes";
+	}
+
+	sav::DecimalColumnReader reader{path};
+	ASSERT_FALSE(reader);
+	ASSERT_EQ(reader.Status(), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(reader.Size(), 0);
+
+	std::remove(path.c_str());
+}
+
+TEST(StreamParserTests, FieldsAcrossChunks)
+{
+	const std::vector<std::string> fields = {"0", "7", "1234", "18446744073709551615", "18446744073709551616",
+		"123456789012345678901234567890123456789012345678901234567890", "00042"};
+
+	std::string text;
+	for(std::size_t i = 0; i < fields.size(); i++)
+	{
+		text += fields[i] + (i % 2 == 0 ? "," : " \r\n");
+	}
+	text += "\n\n";
+
+	// Chunks smaller than most fields, so that values span chunk boundaries.
+	for(std::size_t chunkSize : {1, 5, 16, 4096})
+	{
+		std::istringstream input{text};
+		sav::DecimalStreamParser parser{input, ',', chunkSize};
+
+		sav::Decimal value;
+		for(const auto& field : fields)
+		{
+			ASSERT_TRUE(parser.Next(value));
+			ASSERT_EQ(value, sav::Decimal{field});
+		}
+
+		ASSERT_FALSE(parser.Next(value));
+		ASSERT_TRUE(parser);
+		ASSERT_EQ(parser.Fields(), fields.size());
+	}
+}
+
+TEST(StreamParserTests, BatchesAndErrors)
+{
+	const std::string text = "10;20;30\n40;x5;60";
+	sav::DecimalStreamParser parser{text.data(), text.size(), ';'};
+
+	std::vector<sav::Decimal> batch;
+	ASSERT_EQ(parser.Fill(batch, 3), 3);
+	ASSERT_EQ(parser.Fill(batch, 3), 1);
+	ASSERT_EQ(batch.back(), sav::Decimal{40});
+
+	ASSERT_FALSE(parser);
+	ASSERT_EQ(parser.Status(), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(parser.Fields(), 4);
+}
+
+TEST(QueueTests, BoundedQueues)
+{
+	sav::DecimalSpscQueue<int> ring{3};
+	ASSERT_EQ(ring.Capacity(), 4);
+
+	for(int i = 0; i < 4; i++)
+	{
+		ASSERT_TRUE(ring.TryPush(int{i}));
+	}
+	ASSERT_FALSE(ring.TryPush(4));
+
+	int value = -1;
+	ASSERT_TRUE(ring.TryPop(value));
+	ASSERT_EQ(value, 0);
+
+	constexpr std::uint64_t kCount = 100000;
+
+	// one producer and one consumer: everything arrives, in order
+	sav::DecimalSpscQueue<std::uint64_t> spsc{8};
+	std::thread producer{[&]()
+	{
+		for(std::uint64_t i = 1; i <= kCount; i++)
+		{
+			spsc.Push(std::uint64_t{i});
+		}
+	}};
+
+	for(std::uint64_t i = 1; i <= kCount; i++)
+	{
+		std::uint64_t popped = 0;
+		spsc.Pop(popped);
+		ASSERT_EQ(popped, i);
+	}
+	producer.join();
+
+	// many producers and consumers: everything arrives exactly once
+	constexpr std::uint64_t kThreads = 4;
+	sav::DecimalMpmcQueue<std::uint64_t> mpmc{8};
+	std::atomic<std::uint64_t> sum{0};
+
+	std::vector<std::thread> threads;
+	for(std::uint64_t t = 0; t < kThreads; t++)
+	{
+		threads.emplace_back([&, t]()
+		{
+			for(std::uint64_t i = 1; i <= kCount; i++)
+			{
+				mpmc.Push(t * kCount + i);
+			}
+		});
+
+		threads.emplace_back([&]()
+		{
+			for(std::uint64_t i = 0; i < kCount; i++)
+			{
+				std::uint64_t popped = 0;
+				mpmc.Pop(popped);
+				sum.fetch_add(popped, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(sum.load(), kThreads * kCount * (kThreads * kCount + 1) / 2);
+	std::uint64_t rest = 0;
+	ASSERT_FALSE(mpmc.TryPop(rest));
+}
+
+TEST_F(LargeNumberTests, ReceiptPipelineMatchesSerialComputation)
+{
+	// VATTests receipts first, then random ones (some positions at 10%, some receipts empty)
+	std::string input = "10000\n10000,10000\n 30000 , 30000\r\n20000/10\n";
+	std::string expected = "10000,1667\n20000,3334\n60000,10000\n20000,1818\n";
+
+	for(int receipt = 0; receipt < 1000; receipt++)
+	{
+		sav::Decimal total;
+		sav::Decimal vat;
+
+		const unsigned int positions = Next() % 6;
+		for(unsigned int i = 0; i < positions; i++)
+		{
+			const sav::Decimal price{1 + Next() % 10000000};
+			const unsigned int rate = Next() % 4 == 0 ? 10 : 20;
+
+			input += (i == 0 ? "" : ",") + price.ToString() + (rate == 10 ? "/10" : "");
+			total += price;
+			vat += (price * sav::Decimal{rate}).DivideAndRound(sav::Decimal{100 + rate}, sav::DecimalRoundingMode::HalfUp);
+		}
+
+		input += "\n";
+		expected += total.ToString() + "," + vat.ToString() + "\n";
+	}
+
+	for(std::size_t threads : {1, 4})
+	{
+		sav::DecimalReceiptPipeline::Options options;
+		options.BatchSize = 7;
+		options.QueueCapacity = 2;
+		options.ComputeThreads = threads;
+
+		sav::DecimalReceiptPipeline pipeline{options};
+		std::istringstream in{input};
+		std::ostringstream out;
+
+		ASSERT_EQ(pipeline.Run(in, out), sav::DecimalStatus::Ok);
+		ASSERT_EQ(out.str(), expected);
+		ASSERT_EQ(pipeline.Receipts(), 1004);
+
+		using Stage = sav::DecimalReceiptPipeline::Stage;
+		for(auto stage : {Stage::Parse, Stage::Compute, Stage::Aggregate, Stage::Format})
+		{
+			ASSERT_EQ(pipeline.Statistics(stage).Receipts, 1004);
+			ASSERT_EQ(pipeline.Statistics(stage).Batches, (1004 + 6) / 7);
+		}
+		ASSERT_GE(pipeline.MaxLatencyNanoseconds(), pipeline.MeanLatencyNanoseconds());
+	}
+}
+
+TEST(ReceiptPipelineTests, InvalidReceipt)
+{
+	sav::DecimalReceiptPipeline pipeline;
+
+	for(const char* line : {"200,", "200;300", "20x", "200/", "/10"})
+	{
+		std::istringstream in{std::string{"100\n"} + line + "\n300\n"};
+		std::ostringstream out;
+
+		ASSERT_EQ(pipeline.Run(in, out), sav::DecimalStatus::Error_InvalidArgument);
+		ASSERT_EQ(pipeline.Receipts(), 1);
+		ASSERT_EQ(out.str(), "100,17\n");
+	}
+}
+
+TEST(ReceiptPipelineTests, SlowBatchBoundsReordering)
+{
+	// the first receipt takes far longer to compute than the ones overtaking it in the other worker
+	std::string input;
+	std::string expected = "10000000,1700000\n";
+	for(int i = 0; i < 100000; i++)
+	{
+		input += i == 0 ? "100" : ",100";
+	}
+	input += "\n";
+
+	for(int i = 0; i < 2000; i++)
+	{
+		input += "100\n";
+		expected += "100,17\n";
+	}
+
+	sav::DecimalReceiptPipeline::Options options;
+	options.BatchSize = 1;
+	options.QueueCapacity = 2;
+	options.ComputeThreads = 2;
+
+	sav::DecimalReceiptPipeline pipeline{options};
+	std::istringstream in{input};
+	std::ostringstream out;
+
+	ASSERT_EQ(pipeline.Run(in, out), sav::DecimalStatus::Ok);
+	ASSERT_EQ(out.str(), expected);
+	ASSERT_EQ(pipeline.Receipts(), 2001);
+	ASSERT_LE(pipeline.MaxReorderedBatches(), options.ComputeThreads + 2 * options.QueueCapacity);
+}
+
+TEST_F(LargeNumberTests, CharsRoundTrip)
+{
+	for(int digits : {1, 8, 9, 100, 300, 2000, 6000})
+	{
+		// scaled: low zero limbs
+		for(const auto& value : {Random(digits), Random(digits) * sav::Decimal::Pow2(192)})
+		{
+			std::string text = value.ToString();
+			ASSERT_EQ(text.size(), sav::to_chars_length(value));
+			ASSERT_LE(text.size(), sav::to_chars_max_length(value));
+			ASSERT_NE(text.front(), '0');
+			ASSERT_EQ(sav::Decimal{text}, value);
+
+			// Exactly sized buffer, then one character short.
+			std::vector<char> buffer(text.size());
+			auto written = sav::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+			ASSERT_EQ(written.ec, std::errc{});
+			ASSERT_EQ(std::string(buffer.data(), written.ptr), text);
+
+			written = sav::to_chars(buffer.data(), buffer.data() + buffer.size() - 1, value);
+			ASSERT_EQ(written.ec, std::errc::value_too_large);
+		}
+	}
+}
+
+TEST(CharsTests, PowersOfTen)
+{
+	for(std::uint64_t exponent : {0, 1, 19, 20, 100, 1000, 5000})
+	{
+		auto power = sav::Decimal::Pow10(exponent);
+		ASSERT_EQ(power.ToString(), "1" + std::string(exponent, '0'));
+
+		if(exponent != 0)
+		{
+			auto nines = power - sav::Decimal{1};
+			ASSERT_EQ(nines.ToString(), std::string(exponent, '9'));
+			ASSERT_EQ(sav::to_chars_length(nines), exponent);
+		}
+	}
+}
+
+TEST(CharsTests, FromCharsErrors)
+{
+	sav::Decimal value{5};
+
+	ASSERT_EQ(sav::from_chars(std::string_view{"abc"}, value).ec, std::errc::invalid_argument);
+	ASSERT_EQ(value, sav::Decimal{5});
+
+	std::string_view text = "12345;678";
+	auto parsed = sav::from_chars(text, value);
+	ASSERT_EQ(parsed.ec, std::errc{});
+	ASSERT_EQ(parsed.ptr, text.data() + 5);
+	ASSERT_EQ(value, sav::Decimal{12345});
+
+	ASSERT_FALSE(sav::Decimal{"12a"});
+	ASSERT_EQ(sav::Decimal{}.SetFromString("-1"), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(sav::Decimal{""}, sav::Decimal{0});
+
+	// the rejected string had a valid 2^64 prefix: the zero left behind is canonical
+	sav::Decimal rejected;
+	ASSERT_EQ(rejected.SetFromString("18446744073709551616x"), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_TRUE(rejected.EqualsZero());
+	ASSERT_EQ(rejected, sav::Decimal{});
+	ASSERT_EQ(rejected.Hash(), sav::Decimal{}.Hash());
+}
+
+TEST(SharedDigitsTests, CopyOnWrite)
+{
+	sav::DecimalSharedDigits digits{std::vector<std::uint8_t>{1, 2, 3}};
+	sav::DecimalSharedDigits copy{digits};
+
+	// Reads through const access keep the buffer shared.
+	const auto& constDigits = digits;
+	const auto& constCopy = copy;
+	ASSERT_TRUE(digits.Shared());
+	ASSERT_EQ(constCopy.data(), constDigits.data());
+	ASSERT_EQ(constCopy[2], 3);
+	ASSERT_TRUE(digits.Shared());
+
+	copy[0] = 7;
+	ASSERT_FALSE(digits.Shared());
+	ASSERT_FALSE(copy.Shared());
+	ASSERT_EQ(digits[0], 1);
+	ASSERT_EQ(copy[0], 7);
+
+	copy = digits;
+	copy.clear();
+	ASSERT_EQ(digits.size(), 3);
+	ASSERT_TRUE(copy.empty());
+}
+
+TEST(SharedDigitsTests, ZeroWithoutBuffer)
+{
+	// no buffer and no reference count to share
+	const sav::DecimalSharedDigits zero;
+	sav::DecimalSharedDigits copy{zero};
+	ASSERT_EQ(zero.size(), 1);
+	ASSERT_EQ(zero[0], 0);
+	ASSERT_FALSE(zero.Shared());
+	ASSERT_FALSE(copy.Shared());
+
+	// written to, it gets a buffer of its own
+	copy.push_back(1);
+	ASSERT_EQ(copy.size(), 2);
+	ASSERT_EQ(zero.size(), 1);
+
+	// moved-from values read as zero again
+	sav::Decimal value{42};
+	sav::Decimal moved{std::move(value)};
+	ASSERT_TRUE(value.EqualsZero());
+	ASSERT_EQ(value, sav::Decimal{});
+}
+
+TEST(SharedDigitsTests, CachedText)
+{
+	sav::DecimalSharedDigits digits{std::vector<std::uint8_t>{1, 2, 3}};
+	const auto& constDigits = digits;
+
+	ASSERT_EQ(constDigits.CachedText(0), nullptr);
+	constDigits.CacheText(0, "197121");
+	constDigits.CacheText(0, "ignored");
+
+	// copies share the text, which is kept for one count of implicit zero limbs only
+	sav::DecimalSharedDigits copy{digits};
+	const auto& constCopy = copy;
+	ASSERT_NE(constCopy.CachedText(0), nullptr);
+	ASSERT_EQ(*constCopy.CachedText(0), "197121");
+	ASSERT_EQ(constCopy.CachedText(1), nullptr);
+
+	// write access drops it, from the detached copy as well as from the unique original
+	copy[0] = 7;
+	ASSERT_EQ(constCopy.CachedText(0), nullptr);
+	ASSERT_NE(constDigits.CachedText(0), nullptr);
+	digits.push_back(4);
+	ASSERT_EQ(constDigits.CachedText(0), nullptr);
+}
+
+TEST_F(LargeNumberTests, CachedStringFollowsMutations)
+{
+	std::vector<std::function<void(sav::Decimal&)>> mutations = {
+		[&](sav::Decimal& _value) { _value += Random(40); },
+		[&](sav::Decimal& _value) { _value -= Random(20); },
+		[&](sav::Decimal& _value) { _value *= Random(30); },
+		[](sav::Decimal& _value) { _value++; },
+		[](sav::Decimal& _value) { _value--; },
+		[](sav::Decimal& _value) { _value.SetFromString("123456789012345678901234567890"); },
+		[](sav::Decimal& _value) { sav::from_chars("98765", _value); },
+		[](sav::Decimal& _value) { _value = sav::Decimal::Pow2(128); },
+		[](sav::Decimal& _value) { _value--; },
+	};
+
+	sav::Decimal value = Random(300);
+	for(auto& mutation : mutations)
+	{
+		const std::string text = value.ToCachedString();
+		ASSERT_EQ(value.ToCachedString(), text);
+		ASSERT_EQ(value.ToString(), text);
+
+		const sav::Decimal copy = value;
+		mutation(value);
+
+		ASSERT_EQ(value.ToCachedString(), value.ToString());
+		ASSERT_EQ(copy.ToCachedString(), text);
+	}
+
+	// copies formatted from several threads at once
+	const sav::Decimal shared = Random(500);
+	const std::string expected = shared.ToString();
+
+	std::vector<std::thread> threads;
+	std::atomic<int> mismatches{0};
+	for(int t = 0; t < 4; t++)
+	{
+		threads.emplace_back([&]()
+		{
+			sav::Decimal copy = shared;
+			for(int i = 0; i < 100; i++)
+			{
+				mismatches += copy.ToCachedString() != expected;
+			}
+		});
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(LargeNumberTests, CopiesAreIndependent)
+{
+	auto original = Random(500);
+	const auto expected = original.ToString();
+
+	std::vector<sav::Decimal> copies(8, original);
+	std::vector<std::thread> threads;
+	for(auto& copy : copies)
+	{
+		threads.emplace_back([&copy]()
+		{
+			for(int i = 0; i < 1000; i++)
+			{
+				copy++;
+			}
+		});
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	ASSERT_EQ(original.ToString(), expected);
+	for(const auto& copy : copies)
+	{
+		ASSERT_EQ(copy, original + sav::Decimal{1000});
+	}
+}
+
+TEST_F(LargeNumberTests, RadixSortMatchesComparisonSort)
+{
+	std::vector<sav::Decimal> values;
+	for(int i = 0; i < 1000; i++)
+	{
+		values.emplace_back(Next() % 100000);
+	}
+
+	// values sharing their high limbs, ordered only by the lower ones
+	const auto high = Random(40);
+	for(int i = 0; i < 300; i++)
+	{
+		values.push_back(high + Random(1 + Next() % 24));
+	}
+
+	for(int i = 0; i < 300; i++)
+	{
+		values.push_back(Random(1 + Next() % 60));
+		values.push_back(sav::Decimal::Pow2(64 * (1 + Next() % 3)) * sav::Decimal{Next() % 1000});
+	}
+
+	// zeros sort with the other single-limb values, moved-from ones included
+	values.emplace_back(0);
+	sav::Decimal moved = Random(30);
+	values.push_back(std::move(moved));
+	values.push_back(std::move(moved));
+	values.push_back(sav::Decimal{std::numeric_limits<std::uint64_t>::max()});
+	values.push_back(sav::Decimal::Pow2(64));
+	const std::vector<sav::Decimal> repeated(values.begin(), values.begin() + 200);
+	values.insert(values.end(), repeated.begin(), repeated.end());
+
+	auto expected = values;
+	std::sort(expected.begin(), expected.end());
+
+	const auto copy = values;
+	sav::RadixSort(values);
+	ASSERT_EQ(values, expected);
+
+	for(std::size_t i = 0; i < 50; i++)
+	{
+		std::vector<sav::Decimal> range(copy.begin() + i, copy.begin() + 2 * i);
+		expected = range;
+		std::sort(expected.begin(), expected.end());
+		sav::RadixSort(range);
+		ASSERT_EQ(range, expected);
+	}
+}
+
+TEST(HashTests, EqualValuesHashEqually)
+{
+	const sav::Decimal kMax{std::numeric_limits<std::uint64_t>::max()};
+	const auto power = sav::Decimal::Pow2(64);
+
+	ASSERT_EQ(power.Hash(), (kMax + sav::Decimal{1}).Hash());
+	sav::Decimal parsed;
+	ASSERT_EQ(parsed.SetFromString("18446744073709551616"), sav::DecimalStatus::Ok);
+	ASSERT_EQ(power.Hash(), parsed.Hash());
+	ASSERT_EQ((power * power).Hash(), sav::Decimal::Pow2(128).Hash());
+	ASSERT_EQ((power - power).Hash(), sav::Decimal{0}.Hash());
+	ASSERT_NE(power.Hash(), kMax.Hash());
+	ASSERT_NE(sav::Decimal{1}.Hash(), sav::Decimal{256}.Hash());
+
+	std::unordered_set<sav::Decimal> set{power, kMax + sav::Decimal{1}, sav::Decimal{1}, sav::Decimal{256}};
+	ASSERT_EQ(set.size(), 3u);
+	ASSERT_EQ(set.count(sav::Decimal::Pow2(64)), 1u);
+}
+
+TEST(DedupeTests, KeepsFirstOccurrences)
+{
+	std::vector<sav::Decimal> values;
+	for(std::uint64_t value : {5, 3, 5, 0, 3, 7, 0, 5})
+	{
+		values.emplace_back(value);
+	}
+
+	values.push_back(sav::Decimal::Pow2(64));
+	values.push_back(sav::Decimal{std::numeric_limits<std::uint64_t>::max()} + sav::Decimal{1});
+
+	sav::Dedupe(values);
+	ASSERT_EQ(values, (std::vector<sav::Decimal>{sav::Decimal{5}, sav::Decimal{3}, sav::Decimal{0}, sav::Decimal{7}, sav::Decimal::Pow2(64)}));
+
+	std::vector<sav::Decimal> many;
+	for(std::uint64_t i = 0; i < 10000; i++)
+	{
+		many.emplace_back(i % 1234);
+	}
+
+	sav::Dedupe(many);
+	ASSERT_EQ(many.size(), 1234u);
+	ASSERT_EQ(many.back(), sav::Decimal{1233});
+}
+
+TEST(InstrumentationTests, CountsOperations)
+{
+	using sav::DecimalInstrumentation;
+	using sav::DecimalOperation;
+
+	DecimalInstrumentation::Reset();
+
+	auto product = sav::Decimal{"123456789"} * sav::Decimal{1000};
+	ASSERT_EQ(product.ToString(), "123456789000");
+
+	auto snapshot = DecimalInstrumentation::Snapshot();
+	if(!DecimalInstrumentation::Enabled())
+	{
+		ASSERT_EQ(snapshot[DecimalOperation::Multiply].Calls, 0);
+		return;
+	}
+
+	ASSERT_EQ(snapshot[DecimalOperation::Multiply].Calls, 1);
+	ASSERT_EQ(snapshot[DecimalOperation::Multiply].LimbHistogram[0], 1);
+	ASSERT_EQ(snapshot[DecimalOperation::SetFromString].Calls, 1);
+	ASSERT_EQ(snapshot[DecimalOperation::ToString].Calls, 1);
+	ASSERT_GT(snapshot.BufferAllocations, 0);
+
+	// Counts of other threads are kept after they exit.
+	std::thread([]()
+	{
+		auto sum = sav::Decimal::Pow2(1000) + sav::Decimal{1};
+		ASSERT_TRUE(sum);
+	}).join();
+
+	snapshot = DecimalInstrumentation::Snapshot();
+	ASSERT_EQ(snapshot[DecimalOperation::Add].Calls, 1);
+	// 126 digits, 16 limbs
+	ASSERT_EQ(snapshot[DecimalOperation::Add].LimbHistogram[4], 1);
+
+	DecimalInstrumentation::Reset();
+	ASSERT_EQ(DecimalInstrumentation::Snapshot()[DecimalOperation::Add].Calls, 0);
+}
+
+TEST(KernelTests, X86MatchesPortable)
+{
+	namespace kernels = sav::kernels;
+	using Limb = kernels::Limb;
+
+	if(!kernels::x86::Supported())
+	{
+		GTEST_SKIP() << "the host has no ADX/BMI2";
+	}
+
+	using Binary = Limb (*)(Limb*, const Limb*, const Limb*, std::size_t);
+	using Scalar = Limb (*)(Limb*, const Limb*, std::size_t, Limb);
+
+	std::mt19937_64 random{2019};
+	std::vector<Limb> lhs;
+	std::vector<Limb> rhs;
+	Limb scalar = 0;
+
+	// same carry and limbs, into a separate result (starting as rhs, which AddMul1 adds to) and with _result == _lhs
+	auto binary = [&](Binary _x86, Binary _portable)
+	{
+		auto expected = rhs;
+		auto actual = rhs;
+		ASSERT_EQ(_x86(actual.data(), lhs.data(), rhs.data(), lhs.size()), _portable(expected.data(), lhs.data(), rhs.data(), lhs.size()));
+		ASSERT_EQ(actual, expected);
+
+		expected = lhs;
+		actual = lhs;
+		ASSERT_EQ(_x86(actual.data(), actual.data(), rhs.data(), lhs.size()), _portable(expected.data(), expected.data(), rhs.data(), lhs.size()));
+		ASSERT_EQ(actual, expected);
+	};
+
+	auto unary = [&](Scalar _x86, Scalar _portable)
+	{
+		auto expected = rhs;
+		auto actual = rhs;
+		ASSERT_EQ(_x86(actual.data(), lhs.data(), lhs.size(), scalar), _portable(expected.data(), lhs.data(), lhs.size(), scalar));
+		ASSERT_EQ(actual, expected);
+
+		expected = lhs;
+		actual = lhs;
+		ASSERT_EQ(_x86(actual.data(), actual.data(), lhs.size(), scalar), _portable(expected.data(), expected.data(), lhs.size(), scalar));
+		ASSERT_EQ(actual, expected);
+	};
+
+	// all-ones limbs carry through every position
+	for(std::size_t count = 0; count < 70; count++)
+	{
+		for(bool ones : {true, false})
+		{
+			lhs.resize(count);
+			rhs.resize(count);
+			for(std::size_t i = 0; i < count; i++)
+			{
+				lhs[i] = ones ? std::numeric_limits<Limb>::max() : random();
+				rhs[i] = ones ? std::numeric_limits<Limb>::max() : random();
+			}
+			scalar = ones ? std::numeric_limits<Limb>::max() : random();
+
+			SCOPED_TRACE(::testing::Message() << count << " limbs" << (ones ? ", all ones" : ""));
+			binary(kernels::x86::AddN, kernels::portable::AddN);
+			binary(kernels::x86::SubN, kernels::portable::SubN);
+			unary(kernels::x86::Mul1, kernels::portable::Mul1);
+			unary(kernels::x86::AddMul1, kernels::portable::AddMul1);
+		}
+	}
+}
+
+TEST(ThresholdsTests, ParseConfig)
+{
+	auto defaults = sav::DecimalThresholds::Defaults();
+
+	auto thresholds = defaults;
+	ASSERT_EQ(sav::DecimalThresholds::Parse("# tuned\nkaratsuba = 20\n\n base10=12 # conversions\n", thresholds), sav::DecimalStatus::Ok);
+	ASSERT_EQ(thresholds.Karatsuba, 20);
+	ASSERT_EQ(thresholds.BurnikelZiegler, defaults.BurnikelZiegler);
+	ASSERT_EQ(thresholds.Base10, 12);
+
+	auto parsed = defaults;
+	ASSERT_EQ(sav::DecimalThresholds::Parse(thresholds.ToConfig(), parsed), sav::DecimalStatus::Ok);
+	ASSERT_EQ(parsed.Karatsuba, thresholds.Karatsuba);
+	ASSERT_EQ(parsed.Base10, thresholds.Base10);
+
+	// Errors leave the thresholds unchanged.
+	ASSERT_EQ(sav::DecimalThresholds::Parse("karatsuba = 8\ntoom = 100\n", parsed), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(sav::DecimalThresholds::Parse("karatsuba = -1\n", parsed), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(sav::DecimalThresholds::Parse("karatsuba\n", parsed), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(parsed.Karatsuba, thresholds.Karatsuba);
+
+	ASSERT_EQ(sav::DecimalThresholds::Load("missing-thresholds.conf", parsed), sav::DecimalStatus::Error_IO);
+}
+
+TEST_F(LargeNumberTests, ResultsDoNotDependOnThresholds)
+{
+	auto lhs = Random(2000);
+	auto rhs = Random(900);
+	auto product = lhs * rhs;
+	auto division = lhs / rhs;
+	auto text = lhs.ToString();
+
+	auto saved = sav::DecimalThresholds::Current();
+
+	auto smallest = saved;
+	smallest.Karatsuba = sav::DecimalThresholds::kMinKaratsuba;
+	smallest.BurnikelZiegler = sav::DecimalThresholds::kMinBurnikelZiegler;
+	smallest.Base10 = sav::DecimalThresholds::kMinBase10;
+	ASSERT_EQ(sav::DecimalThresholds::Apply(smallest), sav::DecimalStatus::Ok);
+	ASSERT_EQ(sav::DecimalThresholds::Current().Karatsuba, sav::DecimalThresholds::kMinKaratsuba);
+
+	auto smallestProduct = lhs * rhs;
+	auto smallestDivision = lhs / rhs;
+	auto smallestText = lhs.ToString();
+	auto smallestParsed = sav::Decimal{text};
+
+	smallest.Karatsuba = sav::DecimalThresholds::kMinKaratsuba - 1;
+	ASSERT_EQ(sav::DecimalThresholds::Apply(smallest), sav::DecimalStatus::Error_InvalidArgument);
+	ASSERT_EQ(sav::DecimalThresholds::Apply(saved), sav::DecimalStatus::Ok);
+
+	ASSERT_EQ(smallestProduct, product);
+	ASSERT_EQ(smallestDivision.Quotient, division.Quotient);
+	ASSERT_EQ(smallestDivision.Remainder, division.Remainder);
+	ASSERT_EQ(smallestText, text);
+	ASSERT_EQ(smallestParsed, lhs);
+}
+
 int main()
 {
 	::testing::InitGoogleTest();
@@ -0,0 +1,295 @@
+// MIT License
+//
+// Copyright (c) 2019 Artur Soloviev (soloviev.artur@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "DecimalThresholds.h"
+
+#include "../DecimalKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+/**
+ * Decimal_VLN_BCD_tune - measure the algorithm crossover points on this host.
+ *
+ * Usage:
+ *   Decimal_VLN_BCD_tune [--config <file>] [--header <file>] [--min-time <seconds>] [--max-limbs <n>]
+ *
+ * For every candidate size n the operation is timed twice: with the threshold at n (one level of the
+ * subquadratic algorithm on top of the basecase) and with the subquadratic algorithm disabled. The
+ * threshold is the first n from which the subquadratic level wins three candidates in a row, as
+ * GMP's tuneup does. Karatsuba is tuned first, since the other two algorithms multiply.
+ *
+ * The config file is read at startup through the DECIMAL_VLN_BCD_THRESHOLDS environment variable,
+ * the header is compiled in through the Decimal_VLN_BCD_THRESHOLDS_HEADER CMake cache variable.
+ */
+
+namespace
+{
+	using sav::kernels::Limb;
+	using sav::kernels::Limbs;
+
+	struct Options
+	{
+		std::string m_config;
+		std::string m_header;
+		double m_minTime = 0.02;
+		std::size_t m_maxLimbs = 512;
+	};
+
+	// Disables an algorithm when used as its threshold.
+	const std::size_t kNever = std::numeric_limits<std::size_t>::max() / 64;
+
+	// Results are folded in here, so that the measured operations are not optimized away.
+	volatile Limb g_sink = 0;
+
+	Limbs Operand(std::size_t _count, std::uint64_t _seed)
+	{
+		Limbs result(_count);
+
+		std::uint64_t state = _seed;
+		for(auto& limb : result)
+		{
+			state = state * 6364136223846793005ull + 1442695040888963407ull;
+			limb = state ^ (state >> 29);
+		}
+		result.back() |= Limb{1} << 63;
+
+		return result;
+	}
+
+	// Best time per call of three batches, each one running for at least the minimum time.
+	template<typename Operation>
+	double Measure(const Options& _options, Operation&& _operation)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		double best = std::numeric_limits<double>::max();
+		std::uint64_t iterations = 1;
+
+		for(int round = 0; round < 3; )
+		{
+			auto start = Clock::now();
+			for(std::uint64_t i = 0; i < iterations; i++)
+			{
+				_operation();
+			}
+			double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+			if(elapsed < _options.m_minTime)
+			{
+				iterations *= 2;
+				continue;
+			}
+
+			best = std::min(best, elapsed / static_cast<double>(iterations));
+			round++;
+		}
+
+		return best;
+	}
+
+	/**
+	 * Crossover - first candidate size from which _fast(n) beats _slow(n) three times in a row.
+	 * @return _options.m_maxLimbs if the fast variant never wins
+	 */
+	template<typename Fast, typename Slow>
+	std::size_t Crossover(const char* _name, std::size_t _first, const Options& _options, Fast&& _fast, Slow&& _slow)
+	{
+		std::size_t candidate = 0;
+		int wins = 0;
+
+		for(std::size_t n = _first; n <= _options.m_maxLimbs; n += std::max<std::size_t>(1, n / 8))
+		{
+			double fast = _fast(n);
+			double slow = _slow(n);
+			std::printf("%-18s %6zu limbs %12.0f ns %12.0f ns\n", _name, n, fast * 1e9, slow * 1e9);
+
+			if(fast < slow)
+			{
+				candidate = wins == 0 ? n : candidate;
+				if(++wins == 3)
+				{
+					return candidate;
+				}
+			}
+			else
+			{
+				wins = 0;
+			}
+		}
+
+		return _options.m_maxLimbs;
+	}
+
+	void Apply(const sav::DecimalThresholds& _thresholds)
+	{
+		if(sav::DecimalThresholds::Apply(_thresholds) != sav::DecimalStatus::Ok)
+		{
+			std::cerr << "Invalid thresholds" << std::endl;
+			std::exit(2);
+		}
+	}
+
+	std::size_t TuneKaratsuba(sav::DecimalThresholds& _thresholds, const Options& _options)
+	{
+		auto multiply = [&](std::size_t _n, std::size_t _threshold)
+		{
+			_thresholds.Karatsuba = _threshold;
+			Apply(_thresholds);
+
+			Limbs lhs = Operand(_n, 1);
+			Limbs rhs = Operand(_n, 2);
+			Limbs product(2 * _n);
+
+			return Measure(_options, [&]()
+			{
+				sav::kernels::Mul(product.data(), lhs.data(), _n, rhs.data(), _n);
+				g_sink = g_sink + product[_n];
+			});
+		};
+
+		return Crossover("karatsuba", sav::DecimalThresholds::kMinKaratsuba, _options,
+			[&](std::size_t _n) { return multiply(_n, _n); },
+			[&](std::size_t _n) { return multiply(_n, kNever); });
+	}
+
+	std::size_t TuneBurnikelZiegler(sav::DecimalThresholds& _thresholds, const Options& _options)
+	{
+		auto divide = [&](std::size_t _n, std::size_t _threshold)
+		{
+			_thresholds.BurnikelZiegler = _threshold;
+			Apply(_thresholds);
+
+			Limbs dividend = Operand(2 * _n, 3);
+			Limbs divisor = Operand(_n, 4);
+			Limbs quotient;
+			Limbs remainder;
+
+			return Measure(_options, [&]()
+			{
+				sav::kernels::DivRem(dividend, divisor, quotient, remainder);
+				g_sink = g_sink + quotient[0];
+			});
+		};
+
+		return Crossover("burnikel_ziegler", sav::DecimalThresholds::kMinBurnikelZiegler, _options,
+			[&](std::size_t _n) { return divide(_n, _n); },
+			[&](std::size_t _n) { return divide(_n, kNever); });
+	}
+
+	std::size_t TuneBase10(sav::DecimalThresholds& _thresholds, const Options& _options)
+	{
+		// Both directions share the threshold, so both are timed.
+		auto convert = [&](std::size_t _n, std::size_t _threshold)
+		{
+			_thresholds.Base10 = _threshold;
+			Apply(_thresholds);
+
+			Limbs value = Operand(_n, 5);
+			std::string text(sav::kernels::Base10Length(value), '0');
+
+			return Measure(_options, [&]()
+			{
+				sav::kernels::ToBase10(value, &text[0] + text.size(), text.size());
+				g_sink = g_sink + sav::kernels::FromBase10(text.data(), text.size())[0];
+			});
+		};
+
+		// Values above the threshold go divide and conquer, so n - 1 runs one recursive level at n limbs.
+		return Crossover("base10", sav::DecimalThresholds::kMinBase10 + 1, _options,
+			[&](std::size_t _n) { return convert(_n, _n - 1); },
+			[&](std::size_t _n) { return convert(_n, kNever); }) - 1;
+	}
+
+	bool Write(const std::string& _path, const std::string& _text)
+	{
+		std::ofstream file(_path);
+		file << _text;
+
+		return static_cast<bool>(file);
+	}
+}
+
+int main(int _argc, char** _argv)
+{
+	Options options;
+
+	for(int i = 1; i < _argc; i++)
+	{
+		std::string argument = _argv[i];
+		bool hasValue = i + 1 < _argc;
+
+		if(argument == "--config" && hasValue)
+		{
+			options.m_config = _argv[++i];
+		}
+		else if(argument == "--header" && hasValue)
+		{
+			options.m_header = _argv[++i];
+		}
+		else if(argument == "--min-time" && hasValue)
+		{
+			options.m_minTime = std::stod(_argv[++i]);
+		}
+		else if(argument == "--max-limbs" && hasValue)
+		{
+			options.m_maxLimbs = std::max<std::size_t>(std::stoull(_argv[++i]), 8);
+		}
+		else
+		{
+			std::cerr << "Usage: " << _argv[0] << " [--config <file>] [--header <file>] [--min-time <seconds>] [--max-limbs <n>]" << std::endl;
+			return 2;
+		}
+	}
+
+	std::printf("kernels: %s\n", sav::kernels::KernelsName());
+
+	auto thresholds = sav::DecimalThresholds::Defaults();
+	thresholds.Karatsuba = TuneKaratsuba(thresholds, options);
+	thresholds.BurnikelZiegler = TuneBurnikelZiegler(thresholds, options);
+	thresholds.Base10 = TuneBase10(thresholds, options);
+	Apply(thresholds);
+
+	std::printf("\n%s", thresholds.ToConfig().c_str());
+
+	if(!options.m_config.empty() && !Write(options.m_config, thresholds.ToConfig()))
+	{
+		std::cerr << "Unable to write " << options.m_config << std::endl;
+		return 2;
+	}
+
+	if(!options.m_header.empty() && !Write(options.m_header, thresholds.ToHeader()))
+	{
+		std::cerr << "Unable to write " << options.m_header << std::endl;
+		return 2;
+	}
+
+	return 0;
+}